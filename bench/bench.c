@@ -0,0 +1,74 @@
+#include "harness.h"
+#include <stdio.h>
+#include <string.h>
+
+// Benchmark driver: bench [--json] [--quick] [suite...]
+// Text output is a table; --json emits one JSON object per case so runs
+// can be diffed between releases.
+
+static const bench_suite_t suites[] = {
+    {"create", bench_suite_create},
+    {"parse", bench_suite_parse},
+    {"get", bench_suite_get},
+    {"positional", bench_suite_positional},
+    {"help", bench_suite_help},
+    {"numeric", bench_suite_numeric},
+    {"split", bench_suite_split},
+    {"command", bench_suite_command},
+    {"generated", bench_suite_generated},
+    {"results", bench_suite_results},
+    {"constraints", bench_suite_constraints},
+};
+
+#define SUITE_COUNT (sizeof(suites) / sizeof(suites[0]))
+
+static int selected(int argc, char **argv, const char *name) {
+    int any = 0;
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '-') {
+            continue;
+        }
+        any = 1;
+        if (strcmp(argv[i], name) == 0) {
+            return 1;
+        }
+    }
+    return !any;
+}
+
+int main(int argc, char **argv) {
+    int json = 0;
+    double target_seconds = 0.2;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            json = 1;
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            target_seconds = 0.02;
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Usage: %s [--json] [--quick] [suite...]\n", argv[0]);
+            return 1;
+        } else {
+            int known = 0;
+            for (size_t s = 0; s < SUITE_COUNT; s++) {
+                known |= strcmp(argv[i], suites[s].name) == 0;
+            }
+            if (!known) {
+                fprintf(stderr, "Unknown suite: %s\n", argv[i]);
+                return 1;
+            }
+        }
+    }
+    bench_configure(target_seconds, json);
+
+    if (!json) {
+        printf("%-12s %-36s %14s %12s %12s %14s %12s %14s\n", "suite", "case", "ns/op",
+               "ns/item", "allocs/op", "peak-heap-B", "max-rss-KiB", "cache-miss/op");
+    }
+    for (size_t s = 0; s < SUITE_COUNT; s++) {
+        if (selected(argc, argv, suites[s].name)) {
+            suites[s].run();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "harness.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Parsing from one command string: tokenizing into the parser's reusable
+// buffer against parsing an argv the caller already split.
+
+typedef struct {
+    arg_parser_t *parser;
+    const char *command;
+    size_t length;
+    int argc;
+    char **argv;
+} command_ctx_t;
+
+static arg_parser_t *make_parser(void) {
+    arg_parser_options_t options = bench_options(ARG_PARSER_BORROW_ARGV);
+    arg_parser_t *parser = arg_parser_create_with_options(&options);
+    arg_parser_add_int(parser, "-s", "--shard", "Shard to reindex", false, 0);
+    arg_parser_add_flag(parser, "-f", "--force", "Skip confirmation", false);
+    arg_parser_add_string(parser, "-m", "--message", "Audit message", false, NULL);
+    arg_parser_add_string(parser, "-o", "--output", "Output path", false, NULL);
+    arg_parser_add_int64_list(parser, NULL, "--ids", "Record ids", false, ',');
+    return parser;
+}
+
+static void run_string(void *context) {
+    command_ctx_t *ctx = context;
+    if (arg_parser_parse_string(ctx->parser, ctx->command, ctx->length) != 0) {
+        fprintf(stderr, "bench: command parse failed\n");
+        exit(1);
+    }
+}
+
+static void run_argv(void *context) {
+    command_ctx_t *ctx = context;
+    if (arg_parser_parse(ctx->parser, ctx->argc, ctx->argv) != 0) {
+        fprintf(stderr, "bench: argv parse failed\n");
+        exit(1);
+    }
+}
+
+void bench_suite_command(void) {
+    static const struct {
+        const char *name;
+        const char *command;
+        char *argv[16];
+        int argc;
+    } cases[] = {
+        {"short", "reindex --shard 3 --force",
+         {"bench", "reindex", "--shard", "3", "--force"}, 5},
+        {"quoted",
+         "reindex --shard 12 --message 'nightly run, \"full\" rebuild' "
+         "--output /var/tmp/out\\ dir/index.db --ids 1,2,3,5,8,13,21,34 --force",
+         {"bench", "reindex", "--shard", "12", "--message", "nightly run, \"full\" rebuild",
+          "--output", "/var/tmp/out dir/index.db", "--ids", "1,2,3,5,8,13,21,34", "--force"}, 11},
+    };
+    char name[64];
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        command_ctx_t ctx;
+        ctx.parser = make_parser();
+        ctx.command = cases[c].command;
+        ctx.length = strlen(cases[c].command);
+        ctx.argc = cases[c].argc;
+        ctx.argv = (char **)cases[c].argv;
+        double tokens = (double)(cases[c].argc - 1);
+
+        snprintf(name, sizeof(name), "string/%s", cases[c].name);
+        bench_case("command", name, tokens, run_string, &ctx);
+        snprintf(name, sizeof(name), "argv/%s", cases[c].name);
+        bench_case("command", name, tokens, run_argv, &ctx);
+        arg_parser_destroy(ctx.parser);
+    }
+}
@@ -0,0 +1,105 @@
+#include "harness.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// The same 1..100 range check on every given value, written as a
+// validator and as a declarative constraint, next to no check at all.
+// Each case parses a command line that sets every option and validates
+// all results.
+
+// Fits "--level-<n>" for any size_t
+#define NAME_SIZE 32
+
+typedef struct {
+    arg_parser_t *parser;
+    size_t count;
+    char **names;
+    char **argv;
+    int argc;
+} constraints_ctx_t;
+
+static bool validate_range(arg_value_t value, arg_type_t type, char *error_msg, size_t error_msg_size) {
+    if (type != ARG_TYPE_INT) {
+        return false;
+    }
+    if (value.integer < 1 || value.integer > 100) {
+        snprintf(error_msg, error_msg_size, "must be between 1 and 100, got %d", value.integer);
+        return false;
+    }
+    return true;
+}
+
+typedef enum {
+    CHECK_NONE,
+    CHECK_VALIDATOR,
+    CHECK_DECLARATIVE
+} check_kind_t;
+
+static void setup(constraints_ctx_t *ctx, size_t count, check_kind_t kind) {
+    arg_parser_options_t options = bench_options(ARG_PARSER_BORROW_ARGV);
+    options.definition_capacity = count;
+    ctx->parser = arg_parser_create_with_options(&options);
+    ctx->count = count;
+    ctx->names = bench_xmalloc(count * sizeof(char *));
+    ctx->argv = bench_xmalloc((count * 2 + 1) * sizeof(char *));
+    ctx->argc = 0;
+    ctx->argv[ctx->argc++] = "bench";
+    for (size_t i = 0; i < count; i++) {
+        ctx->names[i] = bench_xmalloc(NAME_SIZE);
+        snprintf(ctx->names[i], NAME_SIZE, "--level-%zu", i);
+        int rc = arg_parser_add_int(ctx->parser, NULL, ctx->names[i], "Level", false, 1);
+        if (rc == 0 && kind == CHECK_VALIDATOR) {
+            rc = arg_parser_set_validator(ctx->parser, ctx->names[i], validate_range);
+        } else if (rc == 0 && kind == CHECK_DECLARATIVE) {
+            rc = arg_parser_set_int_range(ctx->parser, ctx->names[i], 1, 100);
+        }
+        if (rc != 0) {
+            fprintf(stderr, "bench: failed to register %s\n", ctx->names[i]);
+            exit(1);
+        }
+        ctx->argv[ctx->argc++] = ctx->names[i];
+        ctx->argv[ctx->argc++] = "42";
+    }
+}
+
+static void teardown(constraints_ctx_t *ctx) {
+    arg_parser_destroy(ctx->parser);
+    for (size_t i = 0; i < ctx->count; i++) {
+        free(ctx->names[i]);
+    }
+    free(ctx->names);
+    free(ctx->argv);
+}
+
+static void run_parse_validate(void *context) {
+    constraints_ctx_t *ctx = context;
+    size_t errors;
+    if (arg_parser_parse_with_errors(ctx->parser, ctx->argc, ctx->argv, NULL, 0, &errors) != 0) {
+        fprintf(stderr, "bench: validation failed\n");
+        exit(1);
+    }
+}
+
+void bench_suite_constraints(void) {
+    static const size_t counts[] = {10, 1000};
+
+    static const struct {
+        const char *name;
+        check_kind_t kind;
+    } kinds[] = {
+        {"unchecked", CHECK_NONE},
+        {"validator", CHECK_VALIDATOR},
+        {"declarative", CHECK_DECLARATIVE},
+    };
+    char name[64];
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+            constraints_ctx_t ctx;
+            setup(&ctx, counts[c], kinds[k].kind);
+            snprintf(name, sizeof(name), "%s/spec=%zu", kinds[k].name, counts[c]);
+            bench_case("constraints", name, (double)counts[c], run_parse_validate, &ctx);
+            teardown(&ctx);
+        }
+    }
+}
@@ -0,0 +1,146 @@
+#include "harness.h"
+#include "server_args.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Registering a spec at startup against the static spec arg-gen builds
+// from server.args, and lookups through a parser's own index, a compiled
+// spec's interned name slots and the generated matcher.
+
+/**
+ * Register the definitions of the generated spec through the runtime API
+ */
+static arg_parser_t *register_spec(const arg_spec_t *spec) {
+    arg_parser_options_t options = bench_options(0);
+    arg_parser_t *parser = arg_parser_create_with_options(&options);
+    int rc = parser ? 0 : -1;
+    for (size_t i = 0; rc == 0 && i < spec->definition_count; i++) {
+        const arg_def_t *def = &spec->definitions[i];
+        switch (def->type) {
+            case ARG_TYPE_FLAG:
+                rc = arg_parser_add_flag(parser, def->short_name, def->long_name,
+                                         def->description, def->default_value.flag);
+                break;
+            case ARG_TYPE_STRING:
+                rc = arg_parser_add_string(parser, def->short_name, def->long_name,
+                                           def->description, def->required,
+                                           def->default_value.string);
+                break;
+            case ARG_TYPE_INT:
+                rc = arg_parser_add_int(parser, def->short_name, def->long_name,
+                                        def->description, def->required,
+                                        def->default_value.integer);
+                break;
+            case ARG_TYPE_DURATION:
+                rc = arg_parser_add_duration(parser, def->short_name, def->long_name,
+                                             def->description, def->required,
+                                             def->default_value.integer64);
+                break;
+            case ARG_TYPE_SIZE:
+                rc = arg_parser_add_size(parser, def->short_name, def->long_name,
+                                         def->description, def->required,
+                                         def->default_value.uinteger64);
+                break;
+            case ARG_TYPE_DOUBLE:
+                rc = arg_parser_add_double(parser, def->short_name, def->long_name,
+                                           def->description, def->required,
+                                           def->default_value.floating64);
+                break;
+            case ARG_TYPE_INT64_LIST:
+                rc = arg_parser_add_int64_list(parser, def->short_name, def->long_name,
+                                               def->description, def->required, def->delimiter);
+                break;
+            case ARG_TYPE_STRING_LIST:
+                rc = arg_parser_add_string_list(parser, def->short_name, def->long_name,
+                                                def->description, def->required, def->delimiter);
+                break;
+            case ARG_TYPE_RANGE_LIST:
+                rc = arg_parser_add_range_list(parser, def->short_name, def->long_name,
+                                               def->description, def->required, NULL);
+                break;
+            default:
+                rc = -1;
+                break;
+        }
+    }
+    if (rc != 0) {
+        fprintf(stderr, "bench: failed to register server spec\n");
+        exit(1);
+    }
+    return parser;
+}
+
+static void run_register(void *context) {
+    (void)context;
+    arg_parser_t *parser = register_spec(&server_args_spec);
+    arg_parser_destroy(parser);
+}
+
+static void run_static(void *context) {
+    (void)context;
+    arg_parser_options_t options = bench_options(0);
+    arg_parser_t *parser = arg_parser_create_for_spec(&server_args_spec, &options);
+    if (!parser) {
+        fprintf(stderr, "bench: failed to create parser\n");
+        exit(1);
+    }
+    arg_parser_destroy(parser);
+}
+
+typedef struct {
+    arg_parser_t *parser;
+    const char **names;
+    size_t count;
+} lookup_ctx_t;
+
+static void run_lookup(void *context) {
+    lookup_ctx_t *ctx = context;
+    size_t total = 0;
+    for (size_t i = 0; i < ctx->count; i++) {
+        arg_handle_t handle = arg_parser_get_handle(ctx->parser, ctx->names[i]);
+        if (handle == ARG_HANDLE_INVALID) {
+            fprintf(stderr, "bench: lookup of %s failed\n", ctx->names[i]);
+            exit(1);
+        }
+        total += (size_t)handle;
+    }
+    bench_consume((void *)total);
+}
+
+void bench_suite_generated(void) {
+    const arg_spec_t *spec = &server_args_spec;
+    double definitions = (double)spec->definition_count;
+
+    bench_case("generated", "create/registered", definitions, run_register, NULL);
+    bench_case("generated", "create/static", definitions, run_static, NULL);
+
+    // Every long and short name once per operation
+    const char **names = bench_xmalloc(spec->definition_count * 2 * sizeof(char *));
+    size_t count = 0;
+    for (size_t i = 0; i < spec->definition_count; i++) {
+        names[count++] = spec->definitions[i].long_name;
+        if (spec->definitions[i].short_name) {
+            names[count++] = spec->definitions[i].short_name;
+        }
+    }
+
+    lookup_ctx_t ctx = {register_spec(spec), names, count};
+    bench_case("generated", "lookup/index", (double)count, run_lookup, &ctx);
+    arg_spec_t *compiled = arg_spec_compile(ctx.parser);
+    arg_parser_destroy(ctx.parser);
+    if (!compiled) {
+        fprintf(stderr, "bench: failed to compile server spec\n");
+        exit(1);
+    }
+
+    arg_parser_options_t options = bench_options(0);
+    ctx.parser = arg_parser_create_for_spec(compiled, &options);
+    bench_case("generated", "lookup/compiled", (double)count, run_lookup, &ctx);
+    arg_parser_destroy(ctx.parser);
+    arg_spec_destroy(compiled);
+
+    ctx.parser = arg_parser_create_for_spec(spec, &options);
+    bench_case("generated", "lookup/matcher", (double)count, run_lookup, &ctx);
+    arg_parser_destroy(ctx.parser);
+    free(names);
+}
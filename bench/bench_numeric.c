@@ -0,0 +1,159 @@
+#include "harness.h"
+#include "numeric.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Numeric conversion: the library's strict parsers against strtol/strtod,
+// a parse of a command line made of hundreds of tuning knobs, and a list
+// option carrying tens of thousands of IDs.
+
+#define INPUT_COUNT 64
+#define KNOB_COUNT 200
+#define ID_COUNT 20000
+
+static const char *int_inputs[INPUT_COUNT];
+static const char *double_inputs[INPUT_COUNT];
+static char input_storage[2 * INPUT_COUNT][32];
+
+static void make_inputs(void) {
+    static const char *int_samples[] = {"1", "42", "100", "-17", "65536", "1048576",
+                                        "8", "250", "3600", "123456789", "-1", "0"};
+    static const char *double_samples[] = {"0.5", "0.75", "1.0", "3.14159", "1e-3",
+                                           "2.5e10", "0.001", "100", "-0.25", "6.02214076e23",
+                                           "0.1", "99.999"};
+    size_t int_n = sizeof(int_samples) / sizeof(int_samples[0]);
+    size_t double_n = sizeof(double_samples) / sizeof(double_samples[0]);
+
+    for (size_t i = 0; i < INPUT_COUNT; i++) {
+        snprintf(input_storage[i], sizeof(input_storage[i]), "%s", int_samples[i % int_n]);
+        snprintf(input_storage[INPUT_COUNT + i], sizeof(input_storage[i]), "%s",
+                 double_samples[i % double_n]);
+        int_inputs[i] = input_storage[i];
+        double_inputs[i] = input_storage[INPUT_COUNT + i];
+    }
+}
+
+static void run_int_library(void *context) {
+    (void)context;
+    int64_t sum = 0;
+    for (size_t i = 0; i < INPUT_COUNT; i++) {
+        int64_t value;
+        if (arg_parse_int64(int_inputs[i], INT64_MIN, INT64_MAX, &value) == ARG_OK) {
+            sum += value;
+        }
+    }
+    bench_consume((void *)(size_t)sum);
+}
+
+static void run_int_strtol(void *context) {
+    (void)context;
+    long long sum = 0;
+    for (size_t i = 0; i < INPUT_COUNT; i++) {
+        char *end;
+        long long value = strtoll(int_inputs[i], &end, 10);
+        if (*end == '\0') {
+            sum += value;
+        }
+    }
+    bench_consume((void *)(size_t)sum);
+}
+
+static void run_double_library(void *context) {
+    (void)context;
+    double sum = 0.0;
+    for (size_t i = 0; i < INPUT_COUNT; i++) {
+        double value;
+        if (arg_parse_double(double_inputs[i], &value) == ARG_OK) {
+            sum += value;
+        }
+    }
+    bench_consume(&sum);
+}
+
+static void run_double_strtod(void *context) {
+    (void)context;
+    double sum = 0.0;
+    for (size_t i = 0; i < INPUT_COUNT; i++) {
+        char *end;
+        double value = strtod(double_inputs[i], &end);
+        if (*end == '\0') {
+            sum += value;
+        }
+    }
+    bench_consume(&sum);
+}
+
+typedef struct {
+    arg_parser_t *parser;
+    int argc;
+    char **argv;
+} knobs_ctx_t;
+
+static void run_knobs(void *context) {
+    knobs_ctx_t *ctx = context;
+    if (arg_parser_parse(ctx->parser, ctx->argc, ctx->argv) != 0) {
+        fprintf(stderr, "bench: knob parse failed\n");
+        exit(1);
+    }
+}
+
+typedef struct {
+    arg_parser_t *parser;
+    char *argv[3];
+} ids_ctx_t;
+
+static void run_ids(void *context) {
+    ids_ctx_t *ctx = context;
+    size_t count;
+    if (arg_parser_parse(ctx->parser, 3, ctx->argv) != 0 ||
+        !arg_parser_get_int64_list(ctx->parser, "--ids", &count) || count != ID_COUNT) {
+        fprintf(stderr, "bench: id list parse failed\n");
+        exit(1);
+    }
+}
+
+void bench_suite_numeric(void) {
+    make_inputs();
+    bench_case("numeric", "int64/arg_parse_int64", INPUT_COUNT, run_int_library, NULL);
+    bench_case("numeric", "int64/strtoll", INPUT_COUNT, run_int_strtol, NULL);
+    bench_case("numeric", "double/arg_parse_double", INPUT_COUNT, run_double_library, NULL);
+    bench_case("numeric", "double/strtod", INPUT_COUNT, run_double_strtod, NULL);
+
+    // A command line of int and float tuning knobs
+    static char names[2 * KNOB_COUNT][32];
+    knobs_ctx_t ctx;
+    arg_parser_options_t options = bench_options(ARG_PARSER_BORROW_ARGV);
+    ctx.parser = arg_parser_create_with_options(&options);
+    ctx.argc = 1 + 4 * KNOB_COUNT;
+    ctx.argv = bench_xmalloc((size_t)ctx.argc * sizeof(char *));
+    ctx.argv[0] = "bench";
+    for (size_t i = 0; i < KNOB_COUNT; i++) {
+        snprintf(names[2 * i], sizeof(names[0]), "--int-knob-%zu", i);
+        snprintf(names[2 * i + 1], sizeof(names[0]), "--float-knob-%zu", i);
+        arg_parser_add_int(ctx.parser, NULL, names[2 * i], "knob", false, 0);
+        arg_parser_add_float(ctx.parser, NULL, names[2 * i + 1], "knob", false, 0.0f);
+        ctx.argv[1 + 4 * i] = names[2 * i];
+        ctx.argv[2 + 4 * i] = (char *)int_inputs[i % INPUT_COUNT];
+        ctx.argv[3 + 4 * i] = names[2 * i + 1];
+        ctx.argv[4 + 4 * i] = (char *)double_inputs[i % INPUT_COUNT];
+    }
+    bench_case("numeric", "parse/knobs=400", 2 * KNOB_COUNT, run_knobs, &ctx);
+    arg_parser_destroy(ctx.parser);
+    free(ctx.argv);
+
+    // One delimited list option with many IDs
+    ids_ctx_t ids;
+    char *list = bench_xmalloc((size_t)ID_COUNT * 12);
+    size_t length = 0;
+    for (size_t i = 0; i < ID_COUNT; i++) {
+        length += (size_t)sprintf(list + length, i ? ",%zu" : "%zu", 100000 + i * 37);
+    }
+    ids.parser = arg_parser_create_with_options(&options);
+    arg_parser_add_int64_list(ids.parser, NULL, "--ids", "IDs", false, ',');
+    ids.argv[0] = "bench";
+    ids.argv[1] = "--ids";
+    ids.argv[2] = list;
+    bench_case("numeric", "list/int64 ids=20000", ID_COUNT, run_ids, &ids);
+    arg_parser_destroy(ids.parser);
+    free(list);
+}
@@ -0,0 +1,333 @@
+#define _POSIX_C_SOURCE 200809L
+#include "harness.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Suites for the core parser API: registration, parsing, getters,
+// positional-heavy command lines and help rendering.
+
+#define NAME_SIZE 32
+#define MAX_OPTIONS 10000
+
+static char option_names[MAX_OPTIONS][NAME_SIZE];
+
+static const char *option_name(size_t i) {
+    if (option_names[i][0] == '\0') {
+        snprintf(option_names[i], NAME_SIZE, "--option-%zu", i);
+    }
+    return option_names[i];
+}
+
+/**
+ * Register count options, cycling through flag, int, string and float
+ */
+static void register_options(arg_parser_t *parser, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        const char *name = option_name(i);
+        int rc;
+        switch (i % 4) {
+            case 0:
+                rc = arg_parser_add_flag(parser, NULL, name, "benchmark flag", false);
+                break;
+            case 1:
+                rc = arg_parser_add_int(parser, NULL, name, "benchmark int", false, 1);
+                break;
+            case 2:
+                rc = arg_parser_add_string(parser, NULL, name, "benchmark string", false, "default");
+                break;
+            default:
+                rc = arg_parser_add_float(parser, NULL, name, "benchmark float", false, 0.5f);
+                break;
+        }
+        if (rc != 0) {
+            fprintf(stderr, "bench: failed to register %s\n", name);
+            exit(1);
+        }
+    }
+}
+
+static arg_parser_t *make_parser_with(size_t count, const arg_parser_options_t *options) {
+    arg_parser_t *parser = arg_parser_create_with_options(options);
+    if (!parser) {
+        fprintf(stderr, "bench: failed to create parser\n");
+        exit(1);
+    }
+    register_options(parser, count);
+    return parser;
+}
+
+static arg_parser_t *make_parser(size_t count, unsigned flags) {
+    arg_parser_options_t options = bench_options(flags);
+    return make_parser_with(count, &options);
+}
+
+/**
+ * Build argv with `tokens` tokens after argv[0], spreading option uses
+ * across the whole spec
+ */
+static char **make_argv(size_t definitions, size_t tokens) {
+    char **argv = bench_xmalloc((tokens + 1) * sizeof(char *));
+    argv[0] = "bench";
+    size_t i = 1;
+    size_t step = 0;
+    while (i <= tokens) {
+        size_t def = (step++ * 7919) % definitions;
+        if (def % 4 != 0 && i + 1 > tokens) {
+            def -= def % 4;  // Only a flag fits in the last slot
+        }
+        argv[i++] = (char *)option_name(def);
+        switch (def % 4) {
+            case 1:
+                argv[i++] = "42";
+                break;
+            case 2:
+                argv[i++] = "value";
+                break;
+            case 3:
+                argv[i++] = "0.25";
+                break;
+            default:
+                break;
+        }
+    }
+    return argv;
+}
+
+/* ---- create ---- */
+
+typedef struct {
+    size_t count;
+    unsigned flags;
+    void *storage;
+} create_ctx_t;
+
+#define CREATE_STORAGE_SIZE (8u << 20)
+
+static void run_create(void *context) {
+    create_ctx_t *ctx = context;
+    arg_parser_options_t options = bench_options(ctx->flags);
+    if (ctx->storage) {
+        options.storage = ctx->storage;
+        options.storage_size = CREATE_STORAGE_SIZE;
+        options.definition_capacity = ctx->count;
+    }
+    arg_parser_t *parser = make_parser_with(ctx->count, &options);
+    arg_parser_destroy(parser);
+}
+
+void bench_suite_create(void) {
+    static const size_t sizes[] = {5, 50, 500, 10000};
+    void *storage = bench_xmalloc(CREATE_STORAGE_SIZE);
+    char name[64];
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        create_ctx_t ctx = {sizes[s], 0, NULL};
+        snprintf(name, sizeof(name), "register/%zu", sizes[s]);
+        bench_case("create", name, (double)sizes[s], run_create, &ctx);
+
+        ctx.flags = ARG_PARSER_ARENA;
+        snprintf(name, sizeof(name), "register-arena/%zu", sizes[s]);
+        bench_case("create", name, (double)sizes[s], run_create, &ctx);
+
+        // Caller storage with the definition table reserved up front
+        ctx.flags = 0;
+        ctx.storage = storage;
+        snprintf(name, sizeof(name), "register-storage/%zu", sizes[s]);
+        bench_case("create", name, (double)sizes[s], run_create, &ctx);
+    }
+    free(storage);
+}
+
+/* ---- parse ---- */
+
+typedef struct {
+    arg_parser_t *parser;
+    int argc;
+    char **argv;
+} parse_ctx_t;
+
+static void run_parse(void *context) {
+    parse_ctx_t *ctx = context;
+    if (arg_parser_parse(ctx->parser, ctx->argc, ctx->argv) != 0) {
+        fprintf(stderr, "bench: parse failed\n");
+        exit(1);
+    }
+}
+
+/**
+ * Stream over argv without storing anything, converting ints as a caller would
+ */
+static void run_iterate(void *context) {
+    parse_ctx_t *ctx = context;
+    arg_iter_t iter;
+    arg_iter_item_t item;
+    arg_iter_status_t status;
+    size_t total = 0;
+    arg_iter_init(&iter, ctx->parser->spec, ctx->argc, ctx->argv);
+    while ((status = arg_iter_next(&iter, &item)) != ARG_ITER_END) {
+        if (status == ARG_ITER_ERROR) {
+            fprintf(stderr, "bench: iterate failed\n");
+            exit(1);
+        }
+        total += item.value.length + (size_t)item.handle;
+    }
+    bench_consume((void *)total);
+}
+
+void bench_suite_parse(void) {
+    static const size_t specs[] = {5, 100, 10000};
+    static const size_t argcs[] = {10, 100, 1000, 10000, 100000, 1000000};
+    char name[64];
+
+    for (size_t s = 0; s < sizeof(specs) / sizeof(specs[0]); s++) {
+        for (size_t a = 0; a < sizeof(argcs) / sizeof(argcs[0]); a++) {
+            for (int borrow = 0; borrow < 2; borrow++) {
+                parse_ctx_t ctx;
+                ctx.parser = make_parser(specs[s], borrow ? ARG_PARSER_BORROW_ARGV : 0);
+                ctx.argc = (int)argcs[a] + 1;
+                ctx.argv = make_argv(specs[s], argcs[a]);
+
+                snprintf(name, sizeof(name), "%s/spec=%zu/argc=%zu",
+                         borrow ? "borrow" : "copy", specs[s], argcs[a]);
+                bench_case("parse", name, (double)argcs[a], run_parse, &ctx);
+
+                if (borrow) {
+                    snprintf(name, sizeof(name), "iterate/spec=%zu/argc=%zu", specs[s], argcs[a]);
+                    bench_case("parse", name, (double)argcs[a], run_iterate, &ctx);
+                }
+
+                arg_parser_destroy(ctx.parser);
+                free(ctx.argv);
+            }
+        }
+    }
+}
+
+/* ---- get ---- */
+
+typedef struct {
+    arg_parser_t *parser;
+    const char *flag_name, *int_name, *string_name, *float_name;
+    arg_handle_t flag_handle, int_handle, string_handle, float_handle;
+} get_ctx_t;
+
+static void run_get_flag(void *c) { get_ctx_t *x = c; bench_consume((void *)(size_t)arg_parser_get_flag(x->parser, x->flag_name)); }
+static void run_get_flag_h(void *c) { get_ctx_t *x = c; bench_consume((void *)(size_t)arg_parser_get_flag_h(x->parser, x->flag_handle)); }
+static void run_get_int(void *c) { get_ctx_t *x = c; bench_consume((void *)(size_t)arg_parser_get_int(x->parser, x->int_name)); }
+static void run_get_int_h(void *c) { get_ctx_t *x = c; bench_consume((void *)(size_t)arg_parser_get_int_h(x->parser, x->int_handle)); }
+static void run_get_string(void *c) { get_ctx_t *x = c; bench_consume(arg_parser_get_string(x->parser, x->string_name)); }
+static void run_get_string_h(void *c) { get_ctx_t *x = c; bench_consume(arg_parser_get_string_h(x->parser, x->string_handle)); }
+static void run_get_float(void *c) { get_ctx_t *x = c; float v = arg_parser_get_float(x->parser, x->float_name); bench_consume(&v); }
+static void run_get_float_h(void *c) { get_ctx_t *x = c; float v = arg_parser_get_float_h(x->parser, x->float_handle); bench_consume(&v); }
+static void run_is_set(void *c) { get_ctx_t *x = c; bench_consume((void *)(size_t)arg_parser_is_set(x->parser, x->int_name)); }
+static void run_get_handle(void *c) { get_ctx_t *x = c; bench_consume((void *)(size_t)arg_parser_get_handle(x->parser, x->int_name)); }
+static void run_get_result(void *c) { get_ctx_t *x = c; bench_consume(arg_parser_get(x->parser, x->int_name)); }
+
+void bench_suite_get(void) {
+    static const size_t specs[] = {5, 1000};
+    char name[64];
+
+    for (size_t s = 0; s < sizeof(specs) / sizeof(specs[0]); s++) {
+        size_t count = specs[s];
+        get_ctx_t ctx;
+        ctx.parser = make_parser(count, 0);
+
+        // Use the last option of each type so linear scans would show
+        size_t last = (count - 1) - ((count - 1) % 4);
+        ctx.flag_name = option_name(last);
+        ctx.int_name = option_name(last >= 4 ? last - 3 : 1);
+        ctx.string_name = option_name(last >= 4 ? last - 2 : 2);
+        ctx.float_name = option_name(last >= 4 ? last - 1 : 3);
+
+        char *argv[] = {"bench", (char *)ctx.flag_name, (char *)ctx.int_name, "7",
+                        (char *)ctx.string_name, "value", (char *)ctx.float_name, "0.75"};
+        if (arg_parser_parse(ctx.parser, 8, argv) != 0) {
+            fprintf(stderr, "bench: parse failed\n");
+            exit(1);
+        }
+        ctx.flag_handle = arg_parser_get_handle(ctx.parser, ctx.flag_name);
+        ctx.int_handle = arg_parser_get_handle(ctx.parser, ctx.int_name);
+        ctx.string_handle = arg_parser_get_handle(ctx.parser, ctx.string_name);
+        ctx.float_handle = arg_parser_get_handle(ctx.parser, ctx.float_name);
+
+        static const struct {
+            const char *name;
+            bench_fn fn;
+        } cases[] = {
+            {"get_flag", run_get_flag}, {"get_flag_h", run_get_flag_h},
+            {"get_int", run_get_int}, {"get_int_h", run_get_int_h},
+            {"get_string", run_get_string}, {"get_string_h", run_get_string_h},
+            {"get_float", run_get_float}, {"get_float_h", run_get_float_h},
+            {"is_set", run_is_set}, {"get_handle", run_get_handle},
+            {"get", run_get_result},
+        };
+        for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+            snprintf(name, sizeof(name), "%s/spec=%zu", cases[c].name, count);
+            bench_case("get", name, 1.0, cases[c].fn, &ctx);
+        }
+
+        arg_parser_destroy(ctx.parser);
+    }
+}
+
+/* ---- positional ---- */
+
+void bench_suite_positional(void) {
+    static const size_t argcs[] = {1000, 100000, 1000000};
+    char name[64];
+
+    for (size_t a = 0; a < sizeof(argcs) / sizeof(argcs[0]); a++) {
+        char **argv = bench_xmalloc((argcs[a] + 1) * sizeof(char *));
+        argv[0] = "bench";
+        for (size_t i = 1; i <= argcs[a]; i++) {
+            argv[i] = "/var/data/input/part-000000.bin";
+        }
+
+        for (int borrow = 0; borrow < 2; borrow++) {
+            parse_ctx_t ctx;
+            ctx.parser = make_parser(5, borrow ? ARG_PARSER_BORROW_ARGV : 0);
+            ctx.argc = (int)argcs[a] + 1;
+            ctx.argv = argv;
+
+            snprintf(name, sizeof(name), "%s/argc=%zu", borrow ? "borrow" : "copy", argcs[a]);
+            bench_case("positional", name, (double)argcs[a], run_parse, &ctx);
+            arg_parser_destroy(ctx.parser);
+        }
+        free(argv);
+    }
+}
+
+/* ---- help ---- */
+
+static void run_help(void *context) {
+    arg_parser_print_help(context, "bench");
+}
+
+void bench_suite_help(void) {
+    static const size_t specs[] = {5, 100, 1000};
+    char name[64];
+
+    for (size_t s = 0; s < sizeof(specs) / sizeof(specs[0]); s++) {
+        arg_parser_t *parser = make_parser(specs[s], 0);
+
+        // Render into /dev/null; the report goes to the real stdout
+        fflush(stdout);
+        int saved = dup(STDOUT_FILENO);
+        int null_fd = open("/dev/null", O_WRONLY);
+        if (saved < 0 || null_fd < 0) {
+            fprintf(stderr, "bench: cannot redirect stdout\n");
+            exit(1);
+        }
+        dup2(null_fd, STDOUT_FILENO);
+        bench_result_t result = bench_run(run_help, parser);
+        fflush(stdout);
+        dup2(saved, STDOUT_FILENO);
+        close(null_fd);
+        close(saved);
+
+        snprintf(name, sizeof(name), "print_help/spec=%zu", specs[s]);
+        bench_report("help", name, (double)specs[s], &result);
+        arg_parser_destroy(parser);
+    }
+}
@@ -0,0 +1,109 @@
+#include "harness.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Result storage for large specs: every parse restores all results to
+// their defaults and full validation walks all of them, so the size of
+// arg_result_t decides how many cache lines (and pages) each pass touches.
+
+// Fits "--knob-<n>" for any size_t
+#define NAME_SIZE 32
+
+typedef struct {
+    arg_parser_t *parser;
+    size_t count;
+    char **names;
+    char *argv[6];
+} results_ctx_t;
+
+static bool accept_all(arg_value_t value, arg_type_t type, char *error_msg, size_t error_msg_size) {
+    (void)value;
+    (void)type;
+    (void)error_msg;
+    (void)error_msg_size;
+    return true;
+}
+
+static void setup(results_ctx_t *ctx, size_t count) {
+    arg_parser_options_t options = bench_options(ARG_PARSER_BORROW_ARGV);
+    options.definition_capacity = count;
+    ctx->parser = arg_parser_create_with_options(&options);
+    ctx->count = count;
+    ctx->names = bench_xmalloc(count * sizeof(char *));
+    for (size_t i = 0; i < count; i++) {
+        ctx->names[i] = bench_xmalloc(NAME_SIZE);
+        snprintf(ctx->names[i], NAME_SIZE, "--knob-%zu", i);
+        int rc = i % 2 == 0
+                 ? arg_parser_add_int(ctx->parser, NULL, ctx->names[i], "Knob", false, 1)
+                 : arg_parser_add_flag(ctx->parser, NULL, ctx->names[i], "Knob", false);
+        if (rc != 0) {
+            fprintf(stderr, "bench: failed to register %s\n", ctx->names[i]);
+            exit(1);
+        }
+        if (i % 2 == 0) {
+            arg_parser_set_validator(ctx->parser, ctx->names[i], accept_all);
+        }
+    }
+    // A short command line, so the per-result passes dominate
+    ctx->argv[0] = "bench";
+    ctx->argv[1] = ctx->names[0];
+    ctx->argv[2] = "7";
+    ctx->argv[3] = ctx->names[count / 2 | 1];
+    ctx->argv[4] = ctx->names[count - 1];
+    ctx->argv[5] = "-";
+}
+
+static void teardown(results_ctx_t *ctx) {
+    arg_parser_destroy(ctx->parser);
+    for (size_t i = 0; i < ctx->count; i++) {
+        free(ctx->names[i]);
+    }
+    free(ctx->names);
+}
+
+static void run_reparse(void *context) {
+    results_ctx_t *ctx = context;
+    if (arg_parser_parse(ctx->parser, 5, ctx->argv) != 0) {
+        fprintf(stderr, "bench: parse failed\n");
+        exit(1);
+    }
+}
+
+static void run_validate(void *context) {
+    results_ctx_t *ctx = context;
+    size_t errors;
+    if (arg_parser_parse_with_errors(ctx->parser, 5, ctx->argv, NULL, 0, &errors) != 0) {
+        fprintf(stderr, "bench: validation failed\n");
+        exit(1);
+    }
+}
+
+static void run_read_all(void *context) {
+    results_ctx_t *ctx = context;
+    size_t total = 0;
+    for (size_t i = 0; i < ctx->count; i++) {
+        const arg_result_t *result = arg_parser_get_h(ctx->parser, (arg_handle_t)i);
+        total += result && result->is_set;
+    }
+    bench_consume((void *)total);
+}
+
+void bench_suite_results(void) {
+    static const size_t counts[] = {500, 10000, 100000};
+    char name[64];
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        results_ctx_t ctx;
+        setup(&ctx, counts[c]);
+        double items = (double)counts[c];
+
+        snprintf(name, sizeof(name), "reparse/spec=%zu", counts[c]);
+        bench_case("results", name, items, run_reparse, &ctx);
+        snprintf(name, sizeof(name), "validate-all/spec=%zu", counts[c]);
+        bench_case("results", name, items, run_validate, &ctx);
+        snprintf(name, sizeof(name), "read-all/spec=%zu", counts[c]);
+        bench_case("results", name, items, run_read_all, &ctx);
+
+        teardown(&ctx);
+    }
+}
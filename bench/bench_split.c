@@ -0,0 +1,124 @@
+#include "harness.h"
+#include "split.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Delimiter splitting of one huge option value: the library's chunked
+// SIMD scanner against a naive strchr loop, and the full list parse.
+
+#define KEY_COUNT 300000
+
+typedef struct {
+    char *text;
+    size_t length;
+    size_t tokens;
+} split_ctx_t;
+
+/**
+ * Build a comma-separated list of keys averaging about key_length bytes
+ */
+static void make_keys(split_ctx_t *ctx, size_t key_length) {
+    ctx->text = bench_xmalloc(KEY_COUNT * (key_length * 2 + 2) + 1);
+    ctx->length = 0;
+    ctx->tokens = KEY_COUNT;
+    unsigned seed = 12345;
+    for (size_t i = 0; i < KEY_COUNT; i++) {
+        seed = seed * 1103515245u + 12345u;
+        size_t length = key_length / 2 + (seed >> 16) % (key_length + 1);
+        if (i > 0) {
+            ctx->text[ctx->length++] = ',';
+        }
+        for (size_t c = 0; c < length; c++) {
+            ctx->text[ctx->length++] = (char)('a' + (c + i) % 26);
+        }
+    }
+    ctx->text[ctx->length] = '\0';
+}
+
+static void run_strchr(void *context) {
+    split_ctx_t *ctx = context;
+    size_t total = 0;
+    size_t count = 0;
+    const char *p = ctx->text;
+    for (;;) {
+        const char *stop = strchr(p, ',');
+        size_t length = stop ? (size_t)(stop - p) : strlen(p);
+        total += length;
+        count++;
+        if (!stop) {
+            break;
+        }
+        p = stop + 1;
+    }
+    if (count != ctx->tokens) {
+        fprintf(stderr, "bench: strchr split miscounted\n");
+        exit(1);
+    }
+    bench_consume((void *)total);
+}
+
+static void run_split(void *context) {
+    split_ctx_t *ctx = context;
+    size_t total = 0;
+    size_t count = 0;
+    arg_split_t split;
+    arg_string_view_t token;
+    arg_split_init(&split, ctx->text, strlen(ctx->text), ',');
+    while (arg_split_next(&split, &token)) {
+        total += token.length;
+        count++;
+    }
+    if (count != ctx->tokens) {
+        fprintf(stderr, "bench: split miscounted\n");
+        exit(1);
+    }
+    bench_consume((void *)total);
+}
+
+typedef struct {
+    arg_parser_t *parser;
+    char *argv[3];
+    size_t tokens;
+} list_ctx_t;
+
+static void run_list(void *context) {
+    list_ctx_t *ctx = context;
+    size_t count;
+    if (arg_parser_parse(ctx->parser, 3, ctx->argv) != 0 ||
+        !arg_parser_get_string_list(ctx->parser, "--keys", &count) || count != ctx->tokens) {
+        fprintf(stderr, "bench: key list parse failed\n");
+        exit(1);
+    }
+}
+
+void bench_suite_split(void) {
+    static const size_t key_lengths[] = {8, 32};
+    char name[64];
+
+    for (size_t k = 0; k < sizeof(key_lengths) / sizeof(key_lengths[0]); k++) {
+        split_ctx_t ctx;
+        make_keys(&ctx, key_lengths[k]);
+
+        snprintf(name, sizeof(name), "strchr/keys=300k,len~%zu", key_lengths[k]);
+        bench_case("split", name, (double)ctx.tokens, run_strchr, &ctx);
+        snprintf(name, sizeof(name), "%s/keys=300k,len~%zu", arg_split_implementation(),
+                 key_lengths[k]);
+        bench_case("split", name, (double)ctx.tokens, run_split, &ctx);
+
+        // The whole option: splitting plus view storage, borrowing from argv
+        list_ctx_t list;
+        arg_parser_options_t options = bench_options(ARG_PARSER_BORROW_ARGV);
+        list.parser = arg_parser_create_with_options(&options);
+        arg_parser_add_string_list(list.parser, NULL, "--keys", "Keys", false, ',');
+        list.argv[0] = "bench";
+        list.argv[1] = "--keys";
+        list.argv[2] = ctx.text;
+        list.tokens = ctx.tokens;
+        snprintf(name, sizeof(name), "parse/string-list keys=300k,len~%zu", key_lengths[k]);
+        bench_case("split", name, (double)ctx.tokens, run_list, &list);
+        arg_parser_destroy(list.parser);
+
+        free(ctx.text);
+    }
+}
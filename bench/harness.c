@@ -0,0 +1,253 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE  // syscall() for the perf counter
+#include "harness.h"
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define BATCHES 3
+#define ALLOC_HEADER alignof(max_align_t)
+
+static double target_seconds = 0.2;
+static int json_output = 0;
+
+static size_t alloc_calls = 0;
+static size_t live_bytes = 0;
+static size_t peak_bytes = 0;
+
+void bench_configure(double seconds, int json) {
+    target_seconds = seconds;
+    json_output = json;
+}
+
+void *bench_xmalloc(size_t size) {
+    void *ptr = malloc(size == 0 ? 1 : size);
+    if (!ptr) {
+        fprintf(stderr, "bench: out of memory\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+void bench_consume(const void *value) {
+    static const void *volatile sink;
+    sink = value;
+    (void)sink; // The volatile store is the point; this silences set-but-unused
+}
+
+/**
+ * Allocations carry a size header so live bytes can be tracked
+ */
+static void track(size_t added, size_t removed) {
+    live_bytes = live_bytes + added - removed;
+    if (live_bytes > peak_bytes) {
+        peak_bytes = live_bytes;
+    }
+}
+
+static void *counting_allocate(size_t size, void *context) {
+    (void)context;
+    unsigned char *block = malloc(ALLOC_HEADER + size);
+    if (!block) {
+        return NULL;
+    }
+    memcpy(block, &size, sizeof(size));
+    alloc_calls++;
+    track(size, 0);
+    return block + ALLOC_HEADER;
+}
+
+static void *counting_reallocate(void *ptr, size_t size, void *context) {
+    if (!ptr) {
+        return counting_allocate(size, context);
+    }
+    unsigned char *block = (unsigned char *)ptr - ALLOC_HEADER;
+    size_t old_size;
+    memcpy(&old_size, block, sizeof(old_size));
+    unsigned char *new_block = realloc(block, ALLOC_HEADER + size);
+    if (!new_block) {
+        return NULL;
+    }
+    memcpy(new_block, &size, sizeof(size));
+    alloc_calls++;
+    track(size, old_size);
+    return new_block + ALLOC_HEADER;
+}
+
+static void counting_deallocate(void *ptr, void *context) {
+    (void)context;
+    if (!ptr) {
+        return;
+    }
+    unsigned char *block = (unsigned char *)ptr - ALLOC_HEADER;
+    size_t size;
+    memcpy(&size, block, sizeof(size));
+    track(0, size);
+    free(block);
+}
+
+arg_allocator_t bench_allocator(void) {
+    arg_allocator_t allocator = {counting_allocate, counting_reallocate,
+                                 counting_deallocate, NULL};
+    return allocator;
+}
+
+arg_parser_options_t bench_options(unsigned flags) {
+    arg_parser_options_t options = {0};
+    options.flags = flags;
+    options.allocator = bench_allocator();
+    return options;
+}
+
+/**
+ * Open a user-space cache-miss counter for this thread
+ * Returns -1 where hardware counters are unavailable (non-Linux, VMs,
+ * perf_event_paranoid), in which case misses are reported as unknown
+ */
+static int cache_miss_counter(void) {
+#ifdef __linux__
+    static int fd = -2;
+    if (fd == -2) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd < 0) {
+            fd = -1;
+        }
+    }
+    return fd;
+#else
+    return -1;
+#endif
+}
+
+/**
+ * Read the counter, 0 if unavailable
+ */
+static uint64_t read_cache_misses(int fd) {
+    uint64_t count = 0;
+#ifdef __linux__
+    if (fd >= 0 && read(fd, &count, sizeof(count)) != (ssize_t)sizeof(count)) {
+        count = 0;
+    }
+#else
+    (void)fd;
+#endif
+    return count;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static long max_rss_kib(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+bench_result_t bench_run(bench_fn fn, void *context) {
+    bench_result_t result = {0};
+
+    // Warm up once and size the batches from that run
+    double start = now_ns();
+    fn(context);
+    double single = now_ns() - start;
+    double per_batch = target_seconds * 1e9 / BATCHES;
+    size_t iterations = single > 0.0 ? (size_t)(per_batch / single) : 1000000;
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    double best = -1.0;
+    double best_misses = -1.0;
+    size_t calls_before = alloc_calls;
+    peak_bytes = live_bytes;
+    int counter = cache_miss_counter();
+    for (int batch = 0; batch < BATCHES; batch++) {
+#ifdef __linux__
+        if (counter >= 0) {
+            ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+            ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+        start = now_ns();
+        for (size_t i = 0; i < iterations; i++) {
+            fn(context);
+        }
+        double elapsed = (now_ns() - start) / (double)iterations;
+#ifdef __linux__
+        if (counter >= 0) {
+            ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+        }
+#endif
+        double misses = (double)read_cache_misses(counter) / (double)iterations;
+        if (best < 0.0 || elapsed < best) {
+            best = elapsed;
+        }
+        if (best_misses < 0.0 || misses < best_misses) {
+            best_misses = misses;
+        }
+    }
+
+    result.ns_per_op = best;
+    result.allocs_per_op = (double)(alloc_calls - calls_before) / (double)(iterations * BATCHES);
+    result.peak_heap_bytes = peak_bytes;
+    result.max_rss_kib = max_rss_kib();
+    result.cache_misses_per_op = counter >= 0 ? best_misses : -1.0;
+    result.iterations = iterations;
+    return result;
+}
+
+void bench_report(const char *suite, const char *name, double items_per_op,
+                  const bench_result_t *r) {
+    double ns_per_item = items_per_op > 0.0 ? r->ns_per_op / items_per_op : 0.0;
+
+    if (json_output) {
+        printf("{\"suite\":\"%s\",\"case\":\"%s\",\"ns_per_op\":%.2f,"
+               "\"ns_per_item\":%.3f,\"allocs_per_op\":%.3f,"
+               "\"peak_heap_bytes\":%zu,\"max_rss_kib\":%ld,"
+               "\"cache_misses_per_op\":%.1f,\"iterations\":%zu}\n",
+               suite, name, r->ns_per_op, ns_per_item, r->allocs_per_op,
+               r->peak_heap_bytes, r->max_rss_kib, r->cache_misses_per_op, r->iterations);
+    } else {
+        char misses[32] = "-";
+        if (r->cache_misses_per_op >= 0.0) {
+            snprintf(misses, sizeof(misses), "%.1f", r->cache_misses_per_op);
+        }
+        printf("%-12s %-36s %14.1f %12.3f %12.2f %14zu %12ld %14s\n",
+               suite, name, r->ns_per_op, ns_per_item, r->allocs_per_op,
+               r->peak_heap_bytes, r->max_rss_kib, misses);
+    }
+    fflush(stdout);
+}
+
+void bench_case(const char *suite, const char *name, double items_per_op,
+                bench_fn fn, void *context) {
+    bench_result_t result = bench_run(fn, context);
+    bench_report(suite, name, items_per_op, &result);
+}
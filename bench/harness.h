@@ -0,0 +1,92 @@
+#ifndef PROGRAM_ARGUMENTS_BENCH_HARNESS_H
+#define PROGRAM_ARGUMENTS_BENCH_HARNESS_H
+
+#include "program_arguments.h"
+#include <stddef.h>
+
+/**
+ * One measured operation; context is prepared by the suite
+ */
+typedef void (*bench_fn)(void *context);
+
+/**
+ * Measurement of one benchmark case
+ */
+typedef struct {
+    double ns_per_op;        // Best batch average
+    double allocs_per_op;    // Allocator calls through bench_allocator() per op
+    size_t peak_heap_bytes;  // Peak live bytes through bench_allocator() while measuring
+    long max_rss_kib;        // Process peak RSS so far
+    double cache_misses_per_op; // Hardware cache misses per op, -1 if the counter is unavailable
+    size_t iterations;       // Operations per batch
+} bench_result_t;
+
+/**
+ * A benchmark suite
+ */
+typedef struct {
+    const char *name;
+    void (*run)(void);
+} bench_suite_t;
+
+/**
+ * Allocator that counts calls and tracks live bytes; pass it to parsers
+ * so their allocations show up in the results
+ */
+arg_allocator_t bench_allocator(void);
+
+/**
+ * Parser options using bench_allocator() plus the given flags
+ */
+arg_parser_options_t bench_options(unsigned flags);
+
+/**
+ * Run fn repeatedly and measure it
+ */
+bench_result_t bench_run(bench_fn fn, void *context);
+
+/**
+ * Report a measured case (text table row or one JSON line)
+ * @param items_per_op Work items per op (tokens, options, ...) for ns/item, 0 if n/a
+ */
+void bench_report(const char *suite, const char *name, double items_per_op,
+                  const bench_result_t *result);
+
+/**
+ * Measure and report one case
+ * @param items_per_op Work items per op (tokens, options, ...) for ns/item, 0 if n/a
+ */
+void bench_case(const char *suite, const char *name, double items_per_op,
+                bench_fn fn, void *context);
+
+/**
+ * Allocate or die; benchmark setup has no use for recovery
+ */
+void *bench_xmalloc(size_t size);
+
+/**
+ * Keep the compiler from discarding a computed value
+ */
+void bench_consume(const void *value);
+
+/**
+ * Harness configuration, set from the command line
+ */
+void bench_configure(double target_seconds, int json);
+
+/**
+ * Suites
+ */
+void bench_suite_create(void);
+void bench_suite_parse(void);
+void bench_suite_get(void);
+void bench_suite_positional(void);
+void bench_suite_help(void);
+void bench_suite_numeric(void);
+void bench_suite_split(void);
+void bench_suite_command(void);
+void bench_suite_generated(void);
+void bench_suite_results(void);
+void bench_suite_constraints(void);
+
+#endif //PROGRAM_ARGUMENTS_BENCH_HARNESS_H
@@ -0,0 +1,25 @@
+# arg_generate(<target> <spec> <name>)
+#
+# Compiles the declarative argument spec <spec> with arg-gen and adds the
+# generated <name>.c and <name>.h to <target>. The header declares the
+# static spec <name>_spec and one handle constant per argument, and is
+# put on the target's include path.
+function(arg_generate TARGET SPEC NAME)
+    get_filename_component(spec_path "${SPEC}" ABSOLUTE)
+    set(output_dir "${CMAKE_CURRENT_BINARY_DIR}/arg_gen/${TARGET}")
+    set(source "${output_dir}/${NAME}.c")
+    set(header "${output_dir}/${NAME}.h")
+
+    add_custom_command(
+            OUTPUT "${source}" "${header}"
+            COMMAND ${CMAKE_COMMAND} -E make_directory "${output_dir}"
+            COMMAND arg-gen --input "${spec_path}" --name "${NAME}"
+                    --source "${source}" --header "${header}"
+            DEPENDS arg-gen "${spec_path}"
+            COMMENT "Generating argument spec ${NAME} from ${SPEC}"
+            VERBATIM
+    )
+
+    target_sources(${TARGET} PRIVATE "${source}" "${header}")
+    target_include_directories(${TARGET} PRIVATE "${output_dir}")
+endfunction()
@@ -0,0 +1,875 @@
+#include "program_arguments.h"
+#include <stdalign.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// Small programs for the entry points main.c does not use. Each command
+// prints what the library reports, one line per item, so test.sh can check
+// both the accepted and the rejected cases:
+//
+//   example-features <command> [arguments...]
+
+// Validator shared by the commands (must be between 1 and 100)
+static bool validate_count(arg_value_t value, arg_type_t type, char *error_msg, size_t error_msg_size) {
+    if (type != ARG_TYPE_INT) {
+        return false;
+    }
+
+    if (value.integer < 1 || value.integer > 100) {
+        snprintf(error_msg, error_msg_size,
+                "Count must be between 1 and 100, got %d", value.integer);
+        return false;
+    }
+    return true;
+}
+
+// Print an error the way every command reports one
+static void print_error(const arg_error_t *error) {
+    char message[512];
+    arg_error_format(error, message, sizeof(message));
+    printf("error: %s\n", message);
+}
+
+// batch RECORD [-- RECORD...]: parse the records, separated by "--", as one
+// batch on a single thread and print each verdict after the batch is done
+static int run_batch(int argc, char **argv) {
+    arg_parser_t *parser = arg_parser_create();
+    if (!parser) {
+        return 1;
+    }
+    arg_parser_add_int(parser, "-n", "--count", "Number of iterations", false, 10);
+    arg_parser_set_validator(parser, "--count", validate_count);
+    arg_spec_t *spec = arg_spec_compile(parser);
+    arg_parser_destroy(parser);
+    if (!spec) {
+        return 1;
+    }
+
+    // Every record reuses the token before it as its argv[0]
+    arg_batch_input_t inputs[32];
+    size_t count = 0;
+    int start = 0;
+    for (int i = 1; i <= argc && count < 32; i++) {
+        if (i == argc || strcmp(argv[i], "--") == 0) {
+            inputs[count].argc = i - start;
+            inputs[count].argv = argv + start;
+            count++;
+            start = i;
+        }
+    }
+
+    arg_batch_result_t result;
+    if (arg_batch_parse(spec, inputs, count, 1, &result) != 0) {
+        arg_spec_destroy(spec);
+        return 1;
+    }
+    for (size_t r = 0; r < result.record_count; r++) {
+        printf("record %zu: ", r);
+        if (result.records[r].error.code != ARG_OK) {
+            print_error(&result.records[r].error);
+        } else {
+            printf("count=%d\n", result.values[r * result.definition_count].integer);
+        }
+    }
+
+    arg_batch_result_free(&result);
+    arg_spec_destroy(spec);
+    return 0;
+}
+
+// batch-threads RECORDS THREADS: parse generated records on a worker pool
+// and check every record against its own index: record r sets --index r,
+// lists r and r + 1 in --ids (kept in worker storage) and has positional
+// "item-r"; every tenth record also carries an unknown option
+static int run_batch_threads(int argc, char **argv) {
+    if (argc != 3) {
+        return 1;
+    }
+    size_t count = (size_t)strtoul(argv[1], NULL, 10);
+    unsigned threads = (unsigned)strtoul(argv[2], NULL, 10);
+
+    arg_parser_t *parser = arg_parser_create();
+    if (!parser) {
+        return 1;
+    }
+    arg_parser_add_int64(parser, NULL, "--index", "Record index", true, 0);
+    arg_parser_add_int64_list(parser, NULL, "--ids", "Identifiers", false, ',');
+    arg_handle_t index_handle = arg_parser_get_handle(parser, "--index");
+    arg_handle_t ids_handle = arg_parser_get_handle(parser, "--ids");
+    arg_spec_t *spec = arg_spec_compile(parser);
+    arg_parser_destroy(parser);
+    if (!spec) {
+        return 1;
+    }
+
+    // Seven tokens per record: program, --index r, --ids r,r+1, item-r and
+    // an optional --bogus
+    char (*text)[3][48] = calloc(count, sizeof(*text));
+    char **tokens = calloc(count * 7, sizeof(char *));
+    arg_batch_input_t *inputs = calloc(count, sizeof(*inputs));
+    arg_batch_result_t result;
+    int status = 1;
+    if (!text || !tokens || !inputs) {
+        goto done;
+    }
+    for (size_t r = 0; r < count; r++) {
+        char **record = tokens + r * 7;
+        snprintf(text[r][0], sizeof(text[r][0]), "%zu", r);
+        snprintf(text[r][1], sizeof(text[r][1]), "%zu,%zu", r, r + 1);
+        snprintf(text[r][2], sizeof(text[r][2]), "item-%zu", r);
+        record[0] = "batch";
+        record[1] = "--index";
+        record[2] = text[r][0];
+        record[3] = "--ids";
+        record[4] = text[r][1];
+        record[5] = text[r][2];
+        record[6] = "--bogus";
+        inputs[r].argc = r % 10 == 9 ? 7 : 6;
+        inputs[r].argv = record;
+    }
+
+    if (arg_batch_parse(spec, inputs, count, threads, &result) != 0) {
+        goto done;
+    }
+    size_t mismatches = 0;
+    size_t rejected = 0;
+    for (size_t r = 0; r < result.record_count; r++) {
+        const arg_batch_record_t *record = &result.records[r];
+        if (r % 10 == 9) {
+            rejected++;
+            mismatches += record->error.code != ARG_ERR_UNKNOWN_ARGUMENT ||
+                          record->error.argv_index != 6;
+            continue;
+        }
+        const arg_value_t *values = result.values + r * result.definition_count;
+        const arg_list_t *ids = values[ids_handle].list;
+        const int64_t *items = ids ? (const int64_t *)ids->items : NULL;
+        mismatches += record->error.code != ARG_OK ||
+                      values[index_handle].integer64 != (int64_t)r ||
+                      !ids || ids->count != 2 ||
+                      items[0] != (int64_t)r || items[1] != (int64_t)r + 1 ||
+                      record->positional_count != 1 ||
+                      strcmp(result.positionals[record->positional_offset], text[r][2]) != 0;
+    }
+    printf("records=%zu rejected=%zu mismatches=%zu\n", result.record_count, rejected,
+           mismatches);
+    arg_batch_result_free(&result);
+    status = mismatches == 0 ? 0 : 1;
+
+done:
+    free(inputs);
+    free(tokens);
+    free(text);
+    arg_spec_destroy(spec);
+    return status;
+}
+
+// errors ARGS...: collect every error of one command line, keeping at
+// most two, and print the total before the kept ones
+static int run_errors(int argc, char **argv) {
+    arg_parser_t *parser = arg_parser_create();
+    if (!parser) {
+        return 1;
+    }
+    arg_parser_add_string(parser, "-i", "--input", "Input file path (required)", true, NULL);
+    arg_parser_add_int(parser, "-n", "--count", "Number of iterations", false, 10);
+    arg_parser_set_validator(parser, "--count", validate_count);
+
+    arg_error_t errors[2];
+    size_t error_count = 0;
+    int status = arg_parser_parse_with_errors(parser, argc, argv, errors, 2, &error_count);
+    printf("errors: %zu\n", error_count);
+    for (size_t i = 0; i < error_count && i < 2; i++) {
+        print_error(&errors[i]);
+    }
+    if (status == 0) {
+        printf("count=%d\n", arg_parser_get_int(parser, "--count"));
+    }
+
+    arg_parser_destroy(parser);
+    return status == 0 ? 0 : 1;
+}
+
+// values ARGS...: parse typed options and print the ones that were given
+static int run_values(int argc, char **argv) {
+    arg_parser_t *parser = arg_parser_create();
+    if (!parser) {
+        return 1;
+    }
+    arg_parser_add_int64(parser, "-i", "--offset", "Signed offset", false, 0);
+    arg_parser_add_uint64(parser, "-u", "--budget", "Unsigned budget", false, 0);
+    arg_parser_add_double(parser, "-r", "--rate", "Rate", false, 0.0);
+    arg_parser_add_size(parser, "-s", "--size", "Byte size", false, 0);
+    arg_parser_add_duration(parser, "-d", "--duration", "Duration", false, 0);
+    arg_parser_add_range_list(parser, "-c", "--cpus", "CPU list", false, NULL);
+    arg_parser_add_int64_list(parser, "-I", "--ids", "Identifiers", false, ',');
+    arg_parser_add_double_list(parser, "-w", "--weights", "Weights", false, ':');
+    arg_parser_add_string_list(parser, "-T", "--tags", "Tags", false, ',');
+    arg_parser_add_float(parser, "-f", "--fraction", "Fraction", false, 0.0f);
+    arg_parser_set_float_range(parser, "--fraction", 0.0, 0.1);
+
+    if (arg_parser_parse(parser, argc, argv) != 0) {
+        arg_parser_destroy(parser);
+        return 1;
+    }
+    if (arg_parser_is_set(parser, "--offset")) {
+        printf("offset=%lld\n", (long long)arg_parser_get_int64(parser, "--offset"));
+    }
+    if (arg_parser_is_set(parser, "--budget")) {
+        printf("budget=%llu\n", (unsigned long long)arg_parser_get_uint64(parser, "--budget"));
+    }
+    if (arg_parser_is_set(parser, "--rate")) {
+        printf("rate=%.17g\n", arg_parser_get_double(parser, "--rate"));
+    }
+    if (arg_parser_is_set(parser, "--size")) {
+        printf("size=%llu\n", (unsigned long long)arg_parser_get_size(parser, "--size"));
+    }
+    if (arg_parser_is_set(parser, "--duration")) {
+        printf("duration=%lldns\n", (long long)arg_parser_get_duration(parser, "--duration"));
+    }
+    if (arg_parser_is_set(parser, "--fraction")) {
+        printf("fraction=%g\n", arg_parser_get_float(parser, "--fraction"));
+    }
+    if (arg_parser_is_set(parser, "--cpus")) {
+        const arg_range_list_t *cpus = arg_parser_get_range_list(parser, "--cpus");
+        printf("cpus=");
+        for (int64_t v = arg_range_list_next(cpus, 0); v >= 0;
+             v = arg_range_list_next(cpus, (uint64_t)v + 1)) {
+            printf("%lld ", (long long)v);
+        }
+        printf("(%zu)\n", arg_range_list_count(cpus));
+    }
+
+    size_t count;
+    const int64_t *ids = arg_parser_get_int64_list(parser, "--ids", &count);
+    if (count > 0) {
+        printf("ids=");
+        for (size_t i = 0; i < count; i++) {
+            printf("%lld ", (long long)ids[i]);
+        }
+        printf("(%zu)\n", count);
+    }
+    const double *weights = arg_parser_get_double_list(parser, "--weights", &count);
+    if (count > 0) {
+        printf("weights=");
+        for (size_t i = 0; i < count; i++) {
+            printf("%g ", weights[i]);
+        }
+        printf("(%zu)\n", count);
+    }
+    const arg_string_view_t *tags = arg_parser_get_string_list(parser, "--tags", &count);
+    if (count > 0) {
+        printf("tags=");
+        for (size_t i = 0; i < count; i++) {
+            printf("[%.*s]", (int)tags[i].length, tags[i].data);
+        }
+        printf(" (%zu)\n", count);
+    }
+
+    arg_parser_destroy(parser);
+    return 0;
+}
+
+// arena ARGS...: parse the same command line twice with an arena-backed
+// parser, resetting in between, with blocks small enough that long values
+// spill into new ones
+static int run_arena(int argc, char **argv) {
+    arg_parser_options_t options = {0};
+    options.flags = ARG_PARSER_ARENA;
+    options.arena_block_size = 256;
+    arg_parser_t *parser = arg_parser_create_with_options(&options);
+    if (!parser) {
+        return 1;
+    }
+    arg_parser_add_string(parser, "-o", "--output", "Output file path", false, "output.txt");
+    arg_parser_add_int(parser, "-n", "--count", "Number of iterations", false, 10);
+    arg_parser_set_validator(parser, "--count", validate_count);
+
+    for (int pass = 1; pass <= 2; pass++) {
+        if (arg_parser_parse(parser, argc, argv) != 0) {
+            arg_parser_destroy(parser);
+            return 1;
+        }
+        size_t positional_count;
+        arg_parser_get_positional(parser, &positional_count);
+        const char *output = arg_parser_get_string(parser, "--output");
+        printf("pass %d: output length=%zu count=%d positionals=%zu\n", pass,
+               output ? strlen(output) : 0, arg_parser_get_int(parser, "--count"),
+               positional_count);
+        arg_parser_reset(parser);
+    }
+
+    arg_parser_destroy(parser);
+    return 0;
+}
+
+// Allocator that counts its calls and hands out memory from a fixed pool,
+// so a pointer that did not come from it is recognized on release
+typedef struct {
+    alignas(max_align_t) unsigned char pool[1 << 20];
+    size_t used;
+    size_t allocations;
+    size_t reallocations;
+    size_t deallocations;
+    size_t live_bytes;
+    size_t foreign;          // Released pointers the pool never handed out
+} counting_allocator_t;
+
+static void *counting_allocate(size_t size, void *context) {
+    counting_allocator_t *counter = context;
+    size_t header = sizeof(max_align_t);
+    size_t total = header + (size + header - 1) / header * header;
+    if (total > sizeof(counter->pool) - counter->used) {
+        return NULL;
+    }
+    unsigned char *block = counter->pool + counter->used;
+    counter->used += total;
+    memcpy(block, &size, sizeof(size));
+    counter->allocations++;
+    counter->live_bytes += size;
+    return block + header;
+}
+
+static size_t counting_size(counting_allocator_t *counter, void *ptr) {
+    unsigned char *block = (unsigned char *)ptr - sizeof(max_align_t);
+    if (block < counter->pool || block >= counter->pool + counter->used) {
+        counter->foreign++;
+        return 0;
+    }
+    size_t size;
+    memcpy(&size, block, sizeof(size));
+    return size;
+}
+
+static void *counting_reallocate(void *ptr, size_t size, void *context) {
+    counting_allocator_t *counter = context;
+    if (!ptr) {
+        return counting_allocate(size, context);
+    }
+    size_t old_size = counting_size(counter, ptr);
+    void *moved = counting_allocate(size, context);
+    if (!moved) {
+        return NULL;
+    }
+    memcpy(moved, ptr, old_size < size ? old_size : size);
+    // A move is not a new allocation
+    counter->allocations--;
+    counter->live_bytes -= old_size;
+    counter->reallocations++;
+    return moved;
+}
+
+static void counting_deallocate(void *ptr, void *context) {
+    counting_allocator_t *counter = context;
+    if (ptr) {
+        counter->live_bytes -= counting_size(counter, ptr);
+        counter->deallocations++;
+    }
+}
+
+// Bytes the C library heap has handed out; false where that is unknown
+static bool heap_in_use(size_t *bytes) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    *bytes = mallinfo2().uordblks;
+    return true;
+#else
+    *bytes = 0;
+    return false;
+#endif
+}
+
+// allocator [--arena] ARGS...: create, parse and destroy a parser whose
+// memory all comes from a counting allocator, then print the counts and
+// whether the C library heap grew while the parser was alive
+static int run_allocator(int argc, char **argv) {
+    static counting_allocator_t counter;
+    arg_parser_options_t options = {0};
+    options.flags = ARG_PARSER_QUIET;
+    if (argc > 1 && strcmp(argv[1], "--arena") == 0) {
+        options.flags |= ARG_PARSER_ARENA;
+        options.arena_block_size = 256;
+        argc--;
+        argv++;
+    }
+    options.allocator.allocate = counting_allocate;
+    options.allocator.reallocate = counting_reallocate;
+    options.allocator.deallocate = counting_deallocate;
+    options.allocator.context = &counter;
+
+    size_t heap_before, heap_during;
+    bool heap_known = heap_in_use(&heap_before);
+    arg_parser_t *parser = arg_parser_create_with_options(&options);
+    if (!parser) {
+        return 1;
+    }
+    arg_parser_add_string(parser, "-o", "--output", "Output file path", false, "output.txt");
+    arg_parser_add_int(parser, "-n", "--count", "Number of iterations", false, 10);
+    arg_parser_set_validator(parser, "--count", validate_count);
+    int status = arg_parser_parse(parser, argc, argv);
+    int count = arg_parser_get_int(parser, "--count");
+    heap_in_use(&heap_during);
+    size_t live_during = counter.live_bytes;
+    arg_parser_destroy(parser);
+
+    printf("parse=%s count=%d\n", status == 0 ? "ok" : "rejected", count);
+    printf("allocations=%zu deallocations=%zu reallocations=%zu\n",
+           counter.allocations, counter.deallocations, counter.reallocations);
+    printf("live while parsed=%s, after destroy=%zu, foreign=%zu\n",
+           live_during > 0 ? "yes" : "no", counter.live_bytes, counter.foreign);
+    printf("callbacks %s\n", counter.allocations > 0 &&
+           counter.allocations == counter.deallocations &&
+           counter.live_bytes == 0 && counter.foreign == 0 ? "balanced" : "unbalanced");
+    printf("malloc fallback: %s\n", !heap_known ? "unchecked"
+           : heap_during == heap_before ? "none" : "detected");
+    return 0;
+}
+
+// Allocator callbacks for a parser that must never reach an allocator
+static void *trapping_allocate(size_t size, void *context) {
+    (void)size;
+    (void)context;
+    fprintf(stderr, "allocator called\n");
+    abort();
+}
+
+static void *trapping_reallocate(void *ptr, size_t size, void *context) {
+    (void)ptr;
+    return trapping_allocate(size, context);
+}
+
+static void trapping_deallocate(void *ptr, void *context) {
+    (void)ptr;
+    trapping_allocate(0, context);
+}
+
+// storage SIZE ARGS...: run a borrowing parser in the first SIZE bytes of a
+// static buffer, with an allocator that aborts if called, and parse ARGS
+// three times. The report is printed after destroy so that stdio's own
+// buffer does not count as a heap allocation by the parser.
+static int run_storage(int argc, char **argv) {
+    static alignas(max_align_t) unsigned char buffer[16384];
+    if (argc < 2) {
+        return 1;
+    }
+    size_t size = (size_t)strtoul(argv[1], NULL, 10);
+    arg_parser_options_t options = {0};
+    options.flags = ARG_PARSER_BORROW_ARGV | ARG_PARSER_QUIET;
+    options.allocator.allocate = trapping_allocate;
+    options.allocator.reallocate = trapping_reallocate;
+    options.allocator.deallocate = trapping_deallocate;
+    options.storage = buffer;
+    options.storage_size = size < sizeof(buffer) ? size : sizeof(buffer);
+    options.definition_capacity = 4;
+    argc--;
+    argv++;
+
+    size_t heap_before, heap_during;
+    bool heap_known = heap_in_use(&heap_before);
+    arg_parser_t *parser = arg_parser_create_with_options(&options);
+    if (!parser) {
+        printf("create failed\n");
+        return 1;
+    }
+    int added = 0;
+    added += arg_parser_add_string(parser, "-o", "--output", "Output file path", false,
+                                   "output.txt") == 0;
+    added += arg_parser_add_int(parser, "-n", "--count", "Number of iterations", false, 10) == 0;
+    added += arg_parser_add_string_list(parser, "-T", "--tags", "Tags", false, ',') == 0;
+    added += arg_parser_add_range_list(parser, "-c", "--cpus", "CPU list", false, NULL) == 0;
+
+    char report[3][160];
+    size_t used[3] = {0};
+    for (int pass = 0; pass < 3; pass++) {
+        arg_error_t error;
+        size_t error_count;
+        if (arg_parser_parse_with_errors(parser, argc, argv, &error, 1, &error_count) != 0) {
+            char message[128];
+            arg_error_format(&error, message, sizeof(message));
+            snprintf(report[pass], sizeof(report[pass]), "%serror: %s",
+                     error.code == ARG_ERR_CAPACITY ? "capacity " : "", message);
+            continue;
+        }
+        used[pass] = arg_parser_storage_used(parser);
+        size_t positional_count;
+        arg_parser_get_positional(parser, &positional_count);
+        const arg_range_list_t *cpus = arg_parser_get_range_list(parser, "--cpus");
+        snprintf(report[pass], sizeof(report[pass]), "count=%d cpus=%zu positionals=%zu used=%zu",
+                 arg_parser_get_int(parser, "--count"), cpus ? arg_range_list_count(cpus) : 0,
+                 positional_count, used[pass]);
+    }
+    heap_in_use(&heap_during);
+    arg_parser_destroy(parser);
+
+    printf("added=%d/4\n", added);
+    for (int pass = 0; pass < 3; pass++) {
+        printf("pass %d: %s\n", pass + 1, report[pass]);
+    }
+    printf("storage growth after first parse: %s\n",
+           used[1] > used[0] || used[2] > used[0] ? "yes" : "none");
+    printf("malloc fallback: %s\n", !heap_known ? "unchecked"
+           : heap_during == heap_before ? "none" : "detected");
+    return 0;
+}
+
+// Parser for the response and command commands; a leading --borrow
+// argument selects ARG_PARSER_BORROW_ARGV and is dropped from argv
+static arg_parser_t *create_token_parser(unsigned flags, int *argc, char ***argv) {
+    arg_parser_options_t options = {0};
+    options.flags = flags;
+    if (*argc > 1 && strcmp((*argv)[1], "--borrow") == 0) {
+        options.flags |= ARG_PARSER_BORROW_ARGV;
+        (*argc)--;
+        (*argv)++;
+    }
+    arg_parser_t *parser = arg_parser_create_with_options(&options);
+    if (parser) {
+        arg_parser_add_string(parser, "-o", "--output", "Output file path", false, "output.txt");
+        arg_parser_add_int(parser, "-n", "--count", "Number of iterations", false, 10);
+    }
+    return parser;
+}
+
+// Print the values of a token parser, with brackets around every token
+static void print_tokens(arg_parser_t *parser) {
+    printf("output=[%s] count=%d positionals=", arg_parser_get_string(parser, "--output"),
+           arg_parser_get_int(parser, "--count"));
+    size_t positional_count;
+    char **positional_args = arg_parser_get_positional(parser, &positional_count);
+    for (size_t i = 0; i < positional_count; i++) {
+        printf("[%s]", positional_args[i]);
+    }
+    printf("\n");
+}
+
+// response [--borrow] ARGS...: parse with @file expansion
+static int run_response(int argc, char **argv) {
+    arg_parser_t *parser = create_token_parser(ARG_PARSER_RESPONSE_FILES, &argc, &argv);
+    if (!parser) {
+        return 1;
+    }
+    int status = arg_parser_parse(parser, argc, argv);
+    if (status == 0) {
+        print_tokens(parser);
+    }
+    arg_parser_destroy(parser);
+    return status == 0 ? 0 : 1;
+}
+
+// command [--borrow] TEXT: parse one command string, twice so the second
+// parse reuses the buffers of the first
+static int run_command(int argc, char **argv) {
+    arg_parser_t *parser = create_token_parser(0, &argc, &argv);
+    if (!parser || argc != 2) {
+        arg_parser_destroy(parser);
+        return 1;
+    }
+    int status = 0;
+    for (int pass = 0; pass < 2 && status == 0; pass++) {
+        status = arg_parser_parse_string(parser, argv[1], strlen(argv[1]));
+    }
+    if (status == 0) {
+        print_tokens(parser);
+    }
+    arg_parser_destroy(parser);
+    return status == 0 ? 0 : 1;
+}
+
+// iter ARGS...: walk a command line with the iterator, one line per item
+static int run_iter(int argc, char **argv) {
+    arg_parser_t *parser = arg_parser_create();
+    if (!parser) {
+        return 1;
+    }
+    arg_parser_add_flag(parser, "-v", "--verbose", "Enable verbose output", false);
+    arg_parser_add_int(parser, "-n", "--count", "Number of iterations", false, 10);
+    arg_parser_add_string(parser, "-o", "--output", "Output file path", false, "output.txt");
+
+    arg_iter_t iter;
+    arg_iter_item_t item;
+    arg_iter_status_t status;
+    arg_iter_init(&iter, parser->spec, argc, argv);
+    while ((status = arg_iter_next(&iter, &item)) != ARG_ITER_END) {
+        printf("[%d] ", item.argv_index);
+        if (status == ARG_ITER_OPTION) {
+            printf("option %s=%.*s\n", item.definition->long_name,
+                   (int)item.value.length, item.value.data ? item.value.data : "");
+        } else if (status == ARG_ITER_POSITIONAL) {
+            printf("positional %.*s\n", (int)item.value.length, item.value.data);
+        } else {
+            arg_error_t error = {item.error, item.argv_index, item.definition,
+                                 item.value.data, NULL};
+            print_error(&error);
+        }
+    }
+
+    arg_parser_destroy(parser);
+    return 0;
+}
+
+// shared ARGS... [-- ARGS...]: compile a spec, destroy the parser it came
+// from, and parse each command line with its own parser for that spec,
+// printing every parser's values once all of them have parsed
+static int run_shared(int argc, char **argv) {
+    arg_parser_t *builder = arg_parser_create();
+    if (!builder) {
+        return 1;
+    }
+    arg_parser_add_string(builder, "-o", "--output", "Output file path", false, "output.txt");
+    arg_parser_add_int(builder, "-n", "--count", "Number of iterations", false, 10);
+    arg_parser_set_validator(builder, "--count", validate_count);
+    arg_spec_t *spec = arg_spec_compile(builder);
+    arg_parser_destroy(builder);
+    if (!spec) {
+        return 1;
+    }
+
+    arg_parser_t *parsers[2] = {NULL, NULL};
+    int status = 0;
+    int start = 0;
+    for (int p = 0, i = 1; p < 2 && start < argc; i++) {
+        if (i == argc || strcmp(argv[i], "--") == 0) {
+            parsers[p] = arg_parser_create_for_spec(spec, NULL);
+            if (!parsers[p] || arg_parser_parse(parsers[p], i - start, argv + start) != 0) {
+                printf("parser %d: rejected\n", p);
+                status = 1;
+            }
+            p++;
+            start = i;
+        }
+    }
+    for (int p = 0; p < 2 && parsers[p]; p++) {
+        printf("parser %d: output=%s count=%d\n", p,
+               arg_parser_get_string(parsers[p], "--output"),
+               arg_parser_get_int(parsers[p], "--count"));
+    }
+
+    for (int p = 0; p < 2; p++) {
+        arg_parser_destroy(parsers[p]);
+    }
+    arg_spec_destroy(spec);
+    return status;
+}
+
+// Handle of a name as the parse path resolves it, or -1
+static int parse_handle(const arg_spec_t *spec, const char *name) {
+    char *argv[] = {"lookup", (char *)name, NULL};
+    arg_iter_t iter;
+    arg_iter_item_t item;
+    arg_iter_init(&iter, spec, 2, argv);
+    return arg_iter_next(&iter, &item) == ARG_ITER_OPTION ? item.handle : -1;
+}
+
+// lookup NAME...: resolve each name through a parser's own index and
+// through a compiled spec, both as a getter would (long names only) and
+// as the parse path would (long and short names)
+static int run_lookup(int argc, char **argv) {
+    arg_parser_t *builder = arg_parser_create();
+    if (!builder) {
+        return 1;
+    }
+    arg_parser_add_flag(builder, "-v", "--verbose", "Enable verbose output", false);
+    arg_parser_add_flag(builder, "-n", "--dry-run", "Print actions only", false);
+    arg_parser_add_flag(builder, NULL, "--force", "Overwrite files", false);
+    arg_spec_t *spec = arg_spec_compile(builder);
+    arg_parser_t *compiled = spec ? arg_parser_create_for_spec(spec, NULL) : NULL;
+    if (!compiled) {
+        arg_spec_destroy(spec);
+        arg_parser_destroy(builder);
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        printf("%s: get=%d/%d parse=%d/%d\n", argv[i],
+               arg_parser_get_handle(builder, argv[i]), arg_parser_get_handle(compiled, argv[i]),
+               parse_handle(builder->spec, argv[i]), parse_handle(spec, argv[i]));
+    }
+
+    arg_parser_destroy(compiled);
+    arg_spec_destroy(spec);
+    arg_parser_destroy(builder);
+    return 0;
+}
+
+// FNV-1a hash of a name as a compiled spec's slots use it: the low bits
+// pick the first slot probed and the upper half is kept as a tag
+static uint64_t name_hash(const char *name) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char *p = name; *p; p++) {
+        hash ^= (unsigned char)*p;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Check one name through both lookups of a parser's own index and of a
+// compiled spec; returns the number of lookups that disagree with the
+// expected getter and parse-path handles
+static size_t check_name(arg_parser_t *builder, const arg_spec_t *spec, const char *name,
+                         int get, int parse) {
+    arg_parser_t *compiled = arg_parser_create_for_spec(spec, NULL);
+    if (!compiled) {
+        return 1;
+    }
+    size_t mismatches = 0;
+    mismatches += arg_parser_get_handle(builder, name) != get;
+    mismatches += arg_parser_get_handle(compiled, name) != get;
+    mismatches += parse_handle(builder->spec, name) != parse;
+    mismatches += parse_handle(spec, name) != parse;
+    arg_parser_destroy(compiled);
+    if (mismatches > 0) {
+        printf("mismatch: %.40s\n", name);
+    }
+    return mismatches;
+}
+
+// Register flags under the given long names and compile them; short names
+// may be NULL. The parser's own index borrows the names.
+static arg_spec_t *compile_names(arg_parser_t *builder, size_t count, char **long_names,
+                                 char **short_names) {
+    for (size_t i = 0; i < count; i++) {
+        if (arg_parser_add_flag(builder, short_names ? short_names[i] : NULL, long_names[i],
+                                "Generated", false) != 0) {
+            return NULL;
+        }
+    }
+    return arg_spec_compile(builder);
+}
+
+// Check that two names resolve apart, and that looking the second up
+// while only the first is registered misses. Sets *shared if both names
+// have the same tag and first slot in the compiled spec.
+static size_t check_name_pair(char *names[2], bool *shared) {
+    size_t mismatches = 0;
+    for (size_t registered = 1; registered <= 2; registered++) {
+        arg_parser_t *builder = arg_parser_create();
+        arg_spec_t *spec = builder ? compile_names(builder, registered, names, NULL) : NULL;
+        if (!spec) {
+            arg_parser_destroy(builder);
+            return 1;
+        }
+        uint64_t first = name_hash(names[0]);
+        uint64_t second = name_hash(names[1]);
+        uint64_t mask = spec->slot_capacity - 1;
+        *shared = first >> 32 == second >> 32 && (first & mask) == (second & mask);
+        mismatches += check_name(builder, spec, names[0], 0, 0);
+        mismatches += check_name(builder, spec, names[1], registered == 2 ? 1 : -1,
+                                 registered == 2 ? 1 : -1);
+        arg_spec_destroy(spec);
+        arg_parser_destroy(builder);
+    }
+    return mismatches;
+}
+
+// names COUNT FIRST SECOND: register COUNT generated flags, the first 26
+// with short names, and two 300-byte names that differ only in their last
+// byte, then resolve every name and some near misses through both lookups.
+// FIRST and SECOND, meant to share a slot tag and first slot, get a spec
+// of their own.
+static int run_names(int argc, char **argv) {
+    if (argc != 4) {
+        return 1;
+    }
+    size_t count = (size_t)strtoul(argv[1], NULL, 10);
+    bool shared = false;
+    size_t mismatches = check_name_pair(argv + 2, &shared);
+
+    enum { LONG_NAME = 300 };
+    char long_names[3][LONG_NAME + 1];
+    for (int i = 0; i < 3; i++) {
+        memset(long_names[i], 'l', LONG_NAME);
+        memcpy(long_names[i], "--", 2);
+        long_names[i][LONG_NAME] = '\0';
+    }
+    long_names[1][LONG_NAME - 1] = 'm';
+    long_names[2][LONG_NAME - 1] = '\0';
+
+    size_t total = count + 2;
+    char (*generated)[32] = calloc(count + 1, sizeof(*generated));
+    char (*shorts)[3] = calloc(total, sizeof(*shorts));
+    char **long_list = calloc(total, sizeof(char *));
+    char **short_list = calloc(total, sizeof(char *));
+    arg_parser_t *builder = arg_parser_create();
+    arg_spec_t *spec = NULL;
+    int status = 1;
+    if (!generated || !shorts || !long_list || !short_list || !builder) {
+        goto done;
+    }
+    for (size_t i = 0; i <= count; i++) {
+        snprintf(generated[i], sizeof(generated[i]), "--option-%zu", i);
+    }
+    for (size_t i = 0; i < count; i++) {
+        long_list[i] = generated[i];
+        if (i < 26) {
+            shorts[i][0] = '-';
+            shorts[i][1] = (char)('a' + i);
+            short_list[i] = shorts[i];
+        }
+    }
+    long_list[count] = long_names[0];
+    long_list[count + 1] = long_names[1];
+    spec = compile_names(builder, total, long_list, short_list);
+    if (!spec) {
+        goto done;
+    }
+
+    for (size_t i = 0; i < total; i++) {
+        mismatches += check_name(builder, spec, long_list[i], (int)i, (int)i);
+        if (short_list[i]) {
+            mismatches += check_name(builder, spec, short_list[i], -1, (int)i);
+        }
+    }
+    // Near misses: a truncated long name and the next generated name
+    mismatches += check_name(builder, spec, long_names[2], -1, -1);
+    mismatches += check_name(builder, spec, generated[count], -1, -1);
+
+    printf("names=%zu shared slot=%s mismatches=%zu\n", total, shared ? "yes" : "no",
+           mismatches);
+    status = mismatches == 0 ? 0 : 1;
+
+done:
+    arg_spec_destroy(spec);
+    arg_parser_destroy(builder);
+    free(short_list);
+    free(long_list);
+    free(shorts);
+    free(generated);
+    return status;
+}
+
+static const struct {
+    const char *name;
+    int (*run)(int argc, char **argv);
+} commands[] = {
+    {"batch", run_batch},
+    {"batch-threads", run_batch_threads},
+    {"errors", run_errors},
+    {"arena", run_arena},
+    {"allocator", run_allocator},
+    {"storage", run_storage},
+    {"response", run_response},
+    {"command", run_command},
+    {"iter", run_iter},
+    {"shared", run_shared},
+    {"lookup", run_lookup},
+    {"names", run_names},
+    {"values", run_values},
+};
+
+int main(int argc, char *argv[]) {
+    for (size_t i = 0; argc > 1 && i < sizeof(commands) / sizeof(commands[0]); i++) {
+        if (strcmp(argv[1], commands[i].name) == 0) {
+            return commands[i].run(argc - 1, argv + 1);
+        }
+    }
+
+    fprintf(stderr, "Usage: %s <command> [arguments...]\nCommands:", argv[0]);
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        fprintf(stderr, " %s", commands[i].name);
+    }
+    fprintf(stderr, "\n");
+    return 1;
+}
@@ -0,0 +1,51 @@
+#include "resize_args.h"
+#include <stdio.h>
+
+// The same kind of program as main.c, but the arguments come from
+// resize.args: arg-gen compiles them into a static spec at build time, so
+// there are no registration calls and option names resolve through a
+// generated matcher.
+
+// Validator declared by resize_args.h (both dimensions use it)
+bool validate_dimension(arg_value_t value, arg_type_t type, char *error_msg, size_t error_msg_size) {
+    if (type != ARG_TYPE_INT) {
+        return false;
+    }
+
+    if (value.integer < 1 || value.integer > 16384) {
+        snprintf(error_msg, error_msg_size,
+                "Dimension must be between 1 and 16384, got %d", value.integer);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    arg_parser_t *parser = arg_parser_create_for_spec(&resize_args_spec, NULL);
+    if (!parser) {
+        fprintf(stderr, "Failed to create argument parser\n");
+        return 1;
+    }
+
+    if (arg_parser_parse(parser, argc, argv) != 0) {
+        fprintf(stderr, "\n");
+        arg_parser_print_help(parser, argv[0]);
+        arg_parser_destroy(parser);
+        return 1;
+    }
+
+    // Handles come from the generated header
+    printf("Resizing %s to %dx%d (quality %.2f, at most %llu bytes) -> %s\n",
+           arg_parser_get_string_h(parser, RESIZE_ARGS_INPUT),
+           arg_parser_get_int_h(parser, RESIZE_ARGS_WIDTH),
+           arg_parser_get_int_h(parser, RESIZE_ARGS_HEIGHT),
+           arg_parser_get_float_h(parser, RESIZE_ARGS_QUALITY),
+           (unsigned long long)arg_parser_get_size_h(parser, RESIZE_ARGS_MAX_BYTES),
+           arg_parser_get_string_h(parser, RESIZE_ARGS_OUTPUT));
+    if (arg_parser_get_flag_h(parser, RESIZE_ARGS_VERBOSE)) {
+        printf("Verbose mode enabled\n");
+    }
+
+    arg_parser_destroy(parser);
+    return 0;
+}
@@ -2,34 +2,6 @@
 #include <stdio.h>
 #include <string.h>
 
-// Validation function for count (must be between 1 and 100)
-bool validate_count(arg_value_t value, arg_type_t type, char *error_msg, size_t error_msg_size) {
-    if (type != ARG_TYPE_INT) {
-        return false;
-    }
-
-    if (value.integer < 1 || value.integer > 100) {
-        snprintf(error_msg, error_msg_size,
-                "Count must be between 1 and 100, got %d", value.integer);
-        return false;
-    }
-    return true;
-}
-
-// Validation function for threshold (must be between 0.0 and 1.0)
-bool validate_threshold(arg_value_t value, arg_type_t type, char *error_msg, size_t error_msg_size) {
-    if (type != ARG_TYPE_FLOAT) {
-        return false;
-    }
-
-    if (value.floating < 0.0f || value.floating > 1.0f) {
-        snprintf(error_msg, error_msg_size,
-                "Threshold must be between 0.0 and 1.0, got %.2f", value.floating);
-        return false;
-    }
-    return true;
-}
-
 // Validation function for output file (must end with .txt)
 bool validate_output_file(arg_value_t value, arg_type_t type, char *error_msg, size_t error_msg_size) {
     if (type != ARG_TYPE_STRING || !value.string) {
@@ -45,6 +17,9 @@ bool validate_output_file(arg_value_t value, arg_type_t type, char *error_msg, s
     return true;
 }
 
+// Accepted values for --mode, checked by the library without a validator
+static const char *const modes[] = {"fast", "balanced", "thorough"};
+
 int main(int argc, char *argv[]) {
     // Create argument parser
     arg_parser_t *parser = arg_parser_create();
@@ -72,11 +47,17 @@ int main(int argc, char *argv[]) {
     arg_parser_add_float(parser, "-t", "--threshold",
                         "Threshold value", false, 0.5f);
 
+    arg_parser_add_string(parser, "-m", "--mode",
+                         "Processing mode", false, "balanced");
+
     // Set up validators for arguments
-    arg_parser_set_validator(parser, "--count", validate_count);
-    arg_parser_set_validator(parser, "--threshold", validate_threshold);
     arg_parser_set_validator(parser, "--output", validate_output_file);
 
+    // Declarative constraints need no callback
+    arg_parser_set_int_range(parser, "--count", 1, 100);
+    arg_parser_set_float_range(parser, "--threshold", 0.0, 1.0);
+    arg_parser_set_choices(parser, "--mode", modes, sizeof(modes) / sizeof(modes[0]));
+
     // Check for help flag first (before parsing errors)
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
@@ -106,6 +87,7 @@ int main(int argc, char *argv[]) {
     const char *output = arg_parser_get_string(parser, "--output");
     int count = arg_parser_get_int(parser, "--count");
     float threshold = arg_parser_get_float(parser, "--threshold");
+    const char *mode = arg_parser_get_string(parser, "--mode");
 
     printf("=== Program Arguments Example ===\n");
     printf("Verbose mode: %s\n", verbose ? "enabled" : "disabled");
@@ -116,6 +98,8 @@ int main(int argc, char *argv[]) {
            arg_parser_is_set(parser, "--count") ? "" : " (default)");
     printf("Threshold: %.2f%s\n", threshold,
            arg_parser_is_set(parser, "--threshold") ? "" : " (default)");
+    printf("Mode: %s%s\n", mode,
+           arg_parser_is_set(parser, "--mode") ? "" : " (default)");
 
     // Display positional arguments if any
     size_t positional_count;
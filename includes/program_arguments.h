@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /**
  * Argument types supported by the parser
@@ -11,9 +12,57 @@ typedef enum {
     ARG_TYPE_FLAG,      // Boolean flag (--verbose, -v)
     ARG_TYPE_STRING,    // String value (--output file.txt)
     ARG_TYPE_INT,       // Integer value (--count 10)
-    ARG_TYPE_FLOAT      // Float value (--threshold 0.5)
+    ARG_TYPE_FLOAT,     // Float value (--threshold 0.5)
+    ARG_TYPE_INT64,     // 64-bit integer value (--offset -4294967296)
+    ARG_TYPE_UINT64,    // 64-bit unsigned value (--budget 17179869184)
+    ARG_TYPE_DOUBLE,    // Double value (--rate 0.000001)
+    ARG_TYPE_SIZE,      // Byte count with SI/IEC suffix (--cache-size 4G), stored in uinteger64
+    ARG_TYPE_DURATION,  // Duration in nanoseconds (--timeout 1h30m), stored in integer64
+    ARG_TYPE_RANGE_LIST, // Integer ranges (--cpus 0-15,32-47,64), stored in range_list
+    ARG_TYPE_INT64_LIST, // Repeatable/delimited 64-bit integers (--ids 1,2,3), stored in list
+    ARG_TYPE_DOUBLE_LIST, // Repeatable/delimited doubles (--weights 0.5,0.25), stored in list
+    ARG_TYPE_STRING_LIST // Repeatable/delimited strings (--include a --include b), stored in list
 } arg_type_t;
 
+/**
+ * Range list members must be below this value
+ */
+#define ARG_RANGE_LIST_LIMIT (1u << 20)
+
+/**
+ * Set of non-negative integers parsed from a list such as "0-15,32-47:2,64"
+ * Members are stored as a bitset: value v is a member if bit v % 64 of
+ * words[v / 64] is set. Use arg_range_list_contains() and
+ * arg_range_list_next() rather than reading the words directly.
+ */
+typedef struct {
+    uint64_t *words;
+    size_t word_count;       // Enough words to hold the largest member
+    size_t count;            // Number of distinct members
+} arg_range_list_t;
+
+/**
+ * Non-owning view of a string, not necessarily NUL-terminated
+ */
+typedef struct {
+    const char *data;
+    size_t length;
+} arg_string_view_t;
+
+/**
+ * Values of a list option, stored contiguously
+ * items is an int64_t, double or arg_string_view_t array depending on the
+ * option type. Use the typed arg_parser_get_*_list() accessors.
+ */
+typedef struct {
+    void *items;
+    size_t count;
+    size_t capacity;         // Elements allocated, kept across parses
+    char **copies;           // Owned token copies backing string views
+    size_t copy_count;
+    size_t copy_capacity;
+} arg_list_t;
+
 /**
  * Union to hold different argument value types
  */
@@ -22,6 +71,11 @@ typedef union {
     char *string;
     int integer;
     float floating;
+    int64_t integer64;
+    uint64_t uinteger64;
+    double floating64;
+    const arg_range_list_t *range_list; // NULL for an empty default
+    const arg_list_t *list;  // NULL until a value is given
 } arg_value_t;
 
 /**
@@ -46,31 +100,225 @@ typedef struct arg_def {
     bool required;           // Whether argument is required
     arg_value_t default_value; // Default value if not provided
     arg_validator_fn validator; // Optional validation function
+    char delimiter;          // List option separator, '\0' to only accumulate repeats
 } arg_def_t;
 
+/**
+ * Stable handle to an argument definition
+ * Handles index results directly and stay valid for the parser's lifetime
+ */
+typedef int arg_handle_t;
+
+#define ARG_HANDLE_INVALID (-1)
+
+/**
+ * Longest validator message kept, including the terminator
+ */
+#define ARG_VALIDATION_ERROR_SIZE 256
+
 /**
  * Parsed argument result
+ * Kept to 32 bytes so two results share a cache line; the validator
+ * message is allocated only when validation fails.
  */
 typedef struct {
     const arg_def_t *definition;
     arg_value_t value;
-    bool is_set;
-    bool validation_attempted;
-    bool is_valid;
-    char validation_error[256];
+    bool is_set : 1;
+    bool validation_attempted : 1;
+    bool is_valid : 1;
+    bool constraint_failed : 1; // Rejected by a declarative constraint after parsing
+    char *validation_error;  // Validator message (owned by the parser), or NULL
 } arg_result_t;
 
 /**
- * Argument parser context
+ * Parse error codes
  */
-typedef struct arg_parser {
+typedef enum {
+    ARG_OK = 0,
+    ARG_ERR_UNKNOWN_ARGUMENT,   // Option token matches no definition
+    ARG_ERR_MISSING_VALUE,      // Option expecting a value is the last token
+    ARG_ERR_REQUIRED_MISSING,   // Required argument was not provided
+    ARG_ERR_VALIDATION,         // Validator rejected a value
+    ARG_ERR_OUT_OF_MEMORY,      // Allocation failed
+    ARG_ERR_INVALID_NUMBER,     // Numeric value is malformed (e.g. "12abc")
+    ARG_ERR_OUT_OF_RANGE,       // Numeric value does not fit its type
+    ARG_ERR_RESPONSE_FILE,      // @file could not be opened or mapped
+    ARG_ERR_RESPONSE_NESTING,   // @files nested deeper than ARG_RESPONSE_MAX_DEPTH
+    ARG_ERR_RESPONSE_SYNTAX,    // @file ends inside a quoted token
+    ARG_ERR_UNTERMINATED_QUOTE, // Command string ends inside a quoted token
+    ARG_ERR_CAPACITY            // Caller-provided parser storage is full
+} arg_error_code_t;
+
+/**
+ * Parse error details
+ */
+typedef struct {
+    arg_error_code_t code;
+    int argv_index;              // Offending argv index, or -1 if not tied to a token
+    const arg_def_t *definition; // Offending definition, or NULL if unknown
+    const char *argument;        // Offending token (points into argv), or NULL
+    const char *detail;          // Validator message (owned by the parser), or NULL
+} arg_error_t;
+
+/**
+ * Parser option flags
+ */
+#define ARG_PARSER_BORROW_ARGV (1u << 0) // String values and positionals point into argv (no copies)
+#define ARG_PARSER_ARENA       (1u << 1) // Bump-allocate all parser memory, release it in one go
+#define ARG_PARSER_QUIET       (1u << 2) // Never print parse or validation errors to stderr
+#define ARG_PARSER_RESPONSE_FILES (1u << 3) // Expand @path arguments with the tokens of the file
+
+/**
+ * Deepest nesting of response files that include other response files
+ */
+#define ARG_RESPONSE_MAX_DEPTH 16
+
+/**
+ * Allocator callbacks for parser-owned memory
+ * All three callbacks must be set for a custom allocator to be used
+ */
+typedef struct {
+    void *(*allocate)(size_t size, void *context);
+    void *(*reallocate)(void *ptr, size_t size, void *context);
+    void (*deallocate)(void *ptr, void *context);
+    void *context;           // Passed through to every callback
+} arg_allocator_t;
+
+/**
+ * Options for arg_parser_create_with_options()
+ * With storage set, the parser (including the parser struct itself) lives
+ * entirely in that buffer and never calls an allocator, from create to
+ * destroy. Allocations that do not fit fail: registration returns -1 and
+ * parsing reports ARG_ERR_CAPACITY. Combine it with
+ * ARG_PARSER_BORROW_ARGV so that repeated parses reuse their buffers
+ * instead of copying strings, and with definition_capacity so the
+ * definition table is not regrown. Storage must stay valid until
+ * arg_parser_destroy() and must not be shared between parsers.
+ */
+typedef struct {
+    unsigned flags;          // Bitwise OR of ARG_PARSER_* flags
+    arg_allocator_t allocator; // Custom allocator, zero-initialized for malloc/realloc/free
+    size_t arena_block_size; // Arena block size in bytes, 0 for the default
+    void *storage;           // Caller buffer holding all parser memory, NULL to allocate
+    size_t storage_size;     // Size of storage in bytes
+    size_t definition_capacity; // Definitions to reserve up front, 0 for the default
+} arg_parser_options_t;
+
+struct arg_arena_block;
+struct arg_response_file;
+
+/**
+ * Memory source for parser-owned allocations
+ */
+typedef struct {
+    arg_allocator_t allocator;
+    struct arg_arena_block *arena; // Arena block list, newest first
+    size_t arena_block_size;
+    bool use_arena;
+    bool fixed;              // Arena is caller storage and never grows
+} arg_memory_t;
+
+/**
+ * Name slot of a compiled spec
+ * Names live in the spec's pool. The hash tag and length are checked
+ * before the pool is read, so a lookup reads a few adjacent slots and,
+ * almost always, a single name.
+ */
+typedef struct {
+    uint32_t hash;           // Upper half of the name's 64-bit FNV-1a hash
+    uint32_t length;         // Name length in bytes
+    uint32_t offset;         // Name offset in the pool
+    uint32_t definition;     // Definition index + 1, 0 marks an empty slot
+} arg_name_slot_t;
+
+/**
+ * Packed per-definition metadata, one byte per definition in arg_spec_t.traits
+ */
+#define ARG_TRAIT_TYPE      0x0fu // arg_type_t of the definition
+#define ARG_TRAIT_REQUIRED  0x10u // Must be provided
+#define ARG_TRAIT_VALIDATOR 0x20u // Has a validator
+
+/**
+ * Argument specification: the definitions and their name index
+ * A parser owns a mutable spec while arguments are registered;
+ * arg_spec_compile() produces an immutable copy that any number of
+ * parsers, on any number of threads, can share without locking. A
+ * compiled spec is one block: the definitions, the name slots, the
+ * traits and a pool that all names (including the definitions' own name
+ * pointers) are interned into.
+ * arg-gen emits static specs that carry a generated matcher instead of
+ * an index; those live in read-only data and are never destroyed.
+ */
+typedef struct arg_spec {
     arg_def_t *definitions;
     size_t definition_count;
     size_t definition_capacity;
+    size_t *index;           // Open-addressing name index (definition index + 1)
+    size_t index_capacity;   // Slot count, always a power of two
+    uint8_t *traits;         // Compiled: ARG_TRAIT_* bits, indexed like definitions
+    arg_name_slot_t *slots;  // Compiled: open-addressing name slots, used instead of the index
+    size_t slot_capacity;    // Slot count, always a power of two
+    char *names;             // Compiled: pool of NUL-terminated names the slots point into
+    struct arg_constraint *constraints; // Declarative constraints indexed like definitions, or NULL
+    arg_allocator_t allocator; // Owner of a compiled spec's memory
+    int (*match)(const char *name); // Generated name lookup, used instead of the index if set
+} arg_spec_t;
+
+/**
+ * Cursor for arg_iter_next()
+ * Plain data: copy it to save a position, no cleanup needed
+ */
+typedef struct {
+    const arg_spec_t *spec;
+    int argc;
+    char **argv;
+    int index;               // Next argv index to read
+} arg_iter_t;
+
+/**
+ * What arg_iter_next() produced
+ */
+typedef enum {
+    ARG_ITER_END = 0,        // argv is exhausted
+    ARG_ITER_OPTION,         // A registered option and its raw value
+    ARG_ITER_POSITIONAL,     // A non-option argument
+    ARG_ITER_ERROR           // An unknown option or a missing value
+} arg_iter_status_t;
+
+/**
+ * One item from arg_iter_next()
+ * Views point into argv and are NUL-terminated there
+ */
+typedef struct {
+    arg_handle_t handle;         // Definition index, ARG_HANDLE_INVALID if none
+    const arg_def_t *definition; // Matched definition, or NULL
+    arg_string_view_t value;     // Raw value, the positional, or the offending token;
+                                 // {NULL, 0} for flags
+    int argv_index;              // argv index of the option (or positional) token
+    arg_error_code_t error;      // Set for ARG_ITER_ERROR, ARG_OK otherwise
+} arg_iter_item_t;
+
+/**
+ * Argument parser context
+ * Holds the per-parse state (results and positionals) for a spec
+ */
+typedef struct arg_parser {
+    unsigned flags;          // ARG_PARSER_* flags from creation
+    arg_memory_t memory;     // Source of all parser-owned memory
+    arg_spec_t own_spec;     // Spec built by arg_parser_add_*()
+    const arg_spec_t *spec;  // &own_spec, or a shared compiled spec
     arg_result_t *results;
+    size_t result_count;     // Results allocated by the last parse
     char **positional_args;
     size_t positional_count;
     size_t positional_capacity;
+    arg_list_t *lists;       // Storage for list and range list options, indexed like results
+    struct arg_response_file *response_files; // Files mapped by the last parse
+    char *command;           // Tokenized copy of the last command string
+    size_t command_capacity;
+    char **command_argv;     // Token pointers into command
+    size_t command_argv_capacity;
 } arg_parser_t;
 
 /**
@@ -79,6 +327,53 @@ typedef struct arg_parser {
  */
 arg_parser_t *arg_parser_create(void);
 
+/**
+ * Initialize argument parser with options
+ * With ARG_PARSER_BORROW_ARGV, string values and positional arguments are
+ * not copied: they point into the argv passed to arg_parser_parse(), which
+ * must outlive the parser.
+ * With ARG_PARSER_ARENA, all parser memory is carved out of a few large
+ * blocks obtained from the allocator and released together on destroy.
+ * With ARG_PARSER_RESPONSE_FILES, an argument "@path" is replaced by the
+ * tokens of that file: whitespace-separated, with '...' and "..." quoting
+ * and backslash escapes, and further @file arguments expanded up to
+ * ARG_RESPONSE_MAX_DEPTH levels deep. Files are memory-mapped and tokens
+ * stay valid until the next parse or reset.
+ * @param options Parser options, or NULL for defaults
+ * @return The parser, or NULL on failure
+ */
+arg_parser_t *arg_parser_create_with_options(const arg_parser_options_t *options);
+
+/**
+ * Initialize a parser that parses against a compiled spec
+ * The parser only holds per-parse state; it cannot register arguments or
+ * validators. The spec must outlive the parser. Create one parser per
+ * thread to parse concurrently against the same spec.
+ * @param spec Compiled spec from arg_spec_compile()
+ * @param options Parser options, or NULL for defaults
+ * @return The parser, or NULL on failure
+ */
+arg_parser_t *arg_parser_create_for_spec(const arg_spec_t *spec,
+                                         const arg_parser_options_t *options);
+
+/**
+ * Compile a parser's registered arguments into an immutable spec
+ * The spec is a standalone copy in a single allocation from the parser's
+ * allocator; the source parser may be destroyed afterwards. Names are
+ * interned into the spec's pool; descriptions are referenced, not copied,
+ * like in the parser itself.
+ * @param parser The parser whose arguments (and validators) to compile
+ * @return The compiled spec, or NULL on failure
+ */
+arg_spec_t *arg_spec_compile(const arg_parser_t *parser);
+
+/**
+ * Free a compiled spec
+ * All parsers created for the spec must be destroyed first
+ * @param spec The spec to destroy
+ */
+void arg_spec_destroy(arg_spec_t *spec);
+
 /**
  * Add a flag argument (boolean)
  * @param parser The parser instance
@@ -134,6 +429,175 @@ int arg_parser_add_float(arg_parser_t *parser, const char *short_name,
                          const char *long_name, const char *description,
                          bool required, float default_value);
 
+/**
+ * Add a 64-bit integer argument
+ * @param parser The parser instance
+ * @param short_name Short form, can be NULL
+ * @param long_name Long form (e.g., "--offset"), required
+ * @param description Help text for this argument
+ * @param required Whether this argument must be provided
+ * @param default_value Default value if not provided
+ * @return 0 on success, -1 on error
+ */
+int arg_parser_add_int64(arg_parser_t *parser, const char *short_name,
+                         const char *long_name, const char *description,
+                         bool required, int64_t default_value);
+
+/**
+ * Add a 64-bit unsigned integer argument
+ * A leading '-' is rejected rather than wrapped around
+ * @param parser The parser instance
+ * @param short_name Short form, can be NULL
+ * @param long_name Long form (e.g., "--budget"), required
+ * @param description Help text for this argument
+ * @param required Whether this argument must be provided
+ * @param default_value Default value if not provided
+ * @return 0 on success, -1 on error
+ */
+int arg_parser_add_uint64(arg_parser_t *parser, const char *short_name,
+                          const char *long_name, const char *description,
+                          bool required, uint64_t default_value);
+
+/**
+ * Add a double argument
+ * @param parser The parser instance
+ * @param short_name Short form, can be NULL
+ * @param long_name Long form (e.g., "--rate"), required
+ * @param description Help text for this argument
+ * @param required Whether this argument must be provided
+ * @param default_value Default value if not provided
+ * @return 0 on success, -1 on error
+ */
+int arg_parser_add_double(arg_parser_t *parser, const char *short_name,
+                          const char *long_name, const char *description,
+                          bool required, double default_value);
+
+/**
+ * Add a byte size argument
+ * Values are a number with an optional fraction and suffix: B, the SI
+ * KB/MB/GB/TB/PB/EB (powers of 1000), or the IEC KiB/MiB/.../EiB and bare
+ * K/M/G/T/P/E (powers of 1024), case-insensitive. "1.5MiB" is 1572864.
+ * Byte counts that overflow 64 bits are ARG_ERR_OUT_OF_RANGE.
+ * @param parser The parser instance
+ * @param short_name Short form, can be NULL
+ * @param long_name Long form (e.g., "--cache-size"), required
+ * @param description Help text for this argument
+ * @param required Whether this argument must be provided
+ * @param default_value Default byte count if not provided
+ * @return 0 on success, -1 on error
+ */
+int arg_parser_add_size(arg_parser_t *parser, const char *short_name,
+                        const char *long_name, const char *description,
+                        bool required, uint64_t default_value);
+
+/**
+ * Add a duration argument, converted to nanoseconds
+ * Values are one or more number-unit pairs with an optional leading sign,
+ * e.g. "150ms", "2.5s" or "1h30m". Units are ns, us (or µs), ms, s, m and
+ * h; a unit is required except for a bare "0". Durations beyond the int64
+ * nanosecond range (about 292 years) are ARG_ERR_OUT_OF_RANGE.
+ * @param parser The parser instance
+ * @param short_name Short form, can be NULL
+ * @param long_name Long form (e.g., "--timeout"), required
+ * @param description Help text for this argument
+ * @param required Whether this argument must be provided
+ * @param default_value Default duration in nanoseconds if not provided
+ * @return 0 on success, -1 on error
+ */
+int arg_parser_add_duration(arg_parser_t *parser, const char *short_name,
+                            const char *long_name, const char *description,
+                            bool required, int64_t default_value);
+
+/**
+ * Add a range list argument
+ * Values are comma-separated items, each a number n, a range a-b, or a
+ * range with a step a-b:s (a, a+s, a+2s, ... up to b). Items may overlap.
+ * The default uses the same syntax and is parsed here.
+ * @param parser The parser instance
+ * @param short_name Short form, can be NULL
+ * @param long_name Long form (e.g., "--cpus"), required
+ * @param description Help text for this argument
+ * @param required Whether this argument must be provided
+ * @param default_value Default list if not provided, can be NULL for none
+ * @return 0 on success, -1 on error (including a malformed default)
+ */
+int arg_parser_add_range_list(arg_parser_t *parser, const char *short_name,
+                              const char *long_name, const char *description,
+                              bool required, const char *default_value);
+
+/**
+ * Add a 64-bit integer list argument
+ * Every occurrence appends to the list. With a delimiter, each occurrence
+ * is also split on it ("--ids 1,2,3"); an invalid item rejects the whole
+ * occurrence.
+ * @param parser The parser instance
+ * @param short_name Short form, can be NULL
+ * @param long_name Long form (e.g., "--ids"), required
+ * @param description Help text for this argument
+ * @param required Whether this argument must be provided
+ * @param delimiter Item separator, or '\0' to accept one item per occurrence;
+ *        digits, letters, '+', '-' and '.' are not allowed
+ * @return 0 on success, -1 on error
+ */
+int arg_parser_add_int64_list(arg_parser_t *parser, const char *short_name,
+                              const char *long_name, const char *description,
+                              bool required, char delimiter);
+
+/**
+ * Add a double list argument
+ * Same rules as arg_parser_add_int64_list()
+ * @param parser The parser instance
+ * @param short_name Short form, can be NULL
+ * @param long_name Long form (e.g., "--weights"), required
+ * @param description Help text for this argument
+ * @param required Whether this argument must be provided
+ * @param delimiter Item separator, or '\0' to accept one item per occurrence
+ * @return 0 on success, -1 on error
+ */
+int arg_parser_add_double_list(arg_parser_t *parser, const char *short_name,
+                               const char *long_name, const char *description,
+                               bool required, char delimiter);
+
+/**
+ * Add a string list argument
+ * Every occurrence appends to the list, split on the delimiter if one is
+ * given. Items are views: into argv with ARG_PARSER_BORROW_ARGV, otherwise
+ * into parser-owned copies, where they are also NUL-terminated.
+ * @param parser The parser instance
+ * @param short_name Short form, can be NULL
+ * @param long_name Long form (e.g., "--include"), required
+ * @param description Help text for this argument
+ * @param required Whether this argument must be provided
+ * @param delimiter Item separator, or '\0' to accept one item per occurrence
+ * @return 0 on success, -1 on error
+ */
+int arg_parser_add_string_list(arg_parser_t *parser, const char *short_name,
+                               const char *long_name, const char *description,
+                               bool required, char delimiter);
+
+/**
+ * Start iterating over a command line
+ * The iterator matches tokens against the spec like arg_parser_parse()
+ * but converts nothing, stores nothing and never allocates. Values are
+ * handed back raw, required arguments are not checked and @file tokens
+ * are not expanded.
+ * @param iter The cursor to initialize
+ * @param spec The spec to match against: a compiled spec or parser->spec
+ * @param argc Argument count from main
+ * @param argv Argument vector from main; argv[0] is skipped
+ */
+void arg_iter_init(arg_iter_t *iter, const arg_spec_t *spec, int argc, char **argv);
+
+/**
+ * Read the next option or positional
+ * Iteration may continue after ARG_ITER_ERROR; an unknown option consumes
+ * only its own token.
+ * @param iter The cursor, advanced past what was read
+ * @param item Output for the option, positional or error
+ * @return What was read, ARG_ITER_END when argv is exhausted
+ */
+arg_iter_status_t arg_iter_next(arg_iter_t *iter, arg_iter_item_t *item);
+
 /**
  * Set validator for an argument
  * @param parser The parser instance
@@ -144,6 +608,76 @@ int arg_parser_add_float(arg_parser_t *parser, const char *short_name,
 int arg_parser_set_validator(arg_parser_t *parser, const char *long_name,
                              arg_validator_fn validator);
 
+/**
+ * Constrain a signed integer argument to [min, max]
+ * Declarative constraints are checked for every given value right after
+ * parsing, before any validator, and fail like a validator would. Use
+ * INT64_MIN or INT64_MAX to leave one side open.
+ * @param parser The parser instance
+ * @param long_name The long name of an int, int64, duration or int64 list argument
+ * @param min Smallest accepted value
+ * @param max Largest accepted value
+ * @return 0 on success, -1 on error (unknown argument, other type or min > max)
+ */
+int arg_parser_set_int_range(arg_parser_t *parser, const char *long_name,
+                             int64_t min, int64_t max);
+
+/**
+ * Constrain an unsigned integer argument to [min, max]
+ * @param parser The parser instance
+ * @param long_name The long name of a uint64 or size argument
+ * @param min Smallest accepted value
+ * @param max Largest accepted value, UINT64_MAX for no limit
+ * @return 0 on success, -1 on error
+ */
+int arg_parser_set_uint_range(arg_parser_t *parser, const char *long_name,
+                              uint64_t min, uint64_t max);
+
+/**
+ * Constrain a floating-point argument to [min, max]
+ * NaN is always rejected. Use -INFINITY or INFINITY to leave one side open.
+ * For a float argument the bounds are rounded to float first, so values
+ * written exactly like a bound are accepted.
+ * @param parser The parser instance
+ * @param long_name The long name of a float, double or double list argument
+ * @param min Smallest accepted value
+ * @param max Largest accepted value
+ * @return 0 on success, -1 on error
+ */
+int arg_parser_set_float_range(arg_parser_t *parser, const char *long_name,
+                               double min, double max);
+
+/**
+ * Restrict a string argument to a set of values
+ * The array and its strings are referenced, not copied, and must outlive
+ * the parser and any spec compiled from it.
+ * @param parser The parser instance
+ * @param long_name The long name of a string or string list argument
+ * @param choices The accepted values
+ * @param choice_count Number of accepted values
+ * @return 0 on success, -1 on error
+ */
+int arg_parser_set_choices(arg_parser_t *parser, const char *long_name,
+                           const char *const *choices, size_t choice_count);
+
+/**
+ * Require a string argument to start with a prefix
+ * @param parser The parser instance
+ * @param long_name The long name of a string or string list argument
+ * @param prefix The required prefix (referenced, not copied)
+ * @return 0 on success, -1 on error
+ */
+int arg_parser_set_prefix(arg_parser_t *parser, const char *long_name, const char *prefix);
+
+/**
+ * Require a string argument to end with a suffix
+ * @param parser The parser instance
+ * @param long_name The long name of a string or string list argument
+ * @param suffix The required suffix (referenced, not copied)
+ * @return 0 on success, -1 on error
+ */
+int arg_parser_set_suffix(arg_parser_t *parser, const char *long_name, const char *suffix);
+
 /**
  * Parse command line arguments
  * @param parser The parser instance
@@ -153,6 +687,61 @@ int arg_parser_set_validator(arg_parser_t *parser, const char *long_name,
  */
 int arg_parser_parse(arg_parser_t *parser, int argc, char **argv);
 
+/**
+ * Parse arguments from a single command string
+ * The buffer is tokenized like a POSIX shell word list: whitespace
+ * separates tokens, '...' is literal, "..." allows \" and \\ escapes, and a
+ * backslash outside quotes escapes the next character. Every token is an
+ * argument (there is no program name to skip); error argv indexes count
+ * tokens from 1. The text is copied into a buffer the parser reuses, so
+ * steady-state calls allocate nothing per token. With
+ * ARG_PARSER_BORROW_ARGV, values point into that buffer and stay valid
+ * until the next parse.
+ * @param parser The parser instance
+ * @param buffer The command text, need not be NUL-terminated
+ * @param length Length of the command text in bytes
+ * @return 0 on success, -1 on error
+ */
+int arg_parser_parse_string(arg_parser_t *parser, const char *buffer, size_t length);
+
+/**
+ * Parse arguments from a single command string, collecting every error
+ * Tokenizes like arg_parser_parse_string() and reports like
+ * arg_parser_parse_with_errors()
+ * @param parser The parser instance
+ * @param buffer The command text, need not be NUL-terminated
+ * @param length Length of the command text in bytes
+ * @param errors Caller buffer receiving the first `capacity` errors
+ * @param capacity Number of entries in errors
+ * @param error_count Output for the total number of errors, may exceed capacity
+ * @return 0 if there were no errors, -1 otherwise
+ */
+int arg_parser_parse_string_with_errors(arg_parser_t *parser, const char *buffer,
+                                        size_t length, arg_error_t *errors,
+                                        size_t capacity, size_t *error_count);
+
+/**
+ * Reset parse state so the parser can parse another command line
+ * Results return to their defaults in place and the positional buffer is
+ * emptied; both buffers are kept for reuse. arg_parser_parse() resets
+ * implicitly, so this is only needed to drop parsed values early.
+ * With ARG_PARSER_BORROW_ARGV, repeated parses against the same spec do
+ * no heap allocations once the buffers have grown to size. In arena mode,
+ * string copies made by earlier parses are only reclaimed on destroy.
+ * @param parser The parser instance
+ */
+void arg_parser_reset(arg_parser_t *parser);
+
+/**
+ * Get how much of the caller-provided storage the parser has used
+ * Includes the storage's own bookkeeping, so the high-water mark after a
+ * representative run (plus alignment slack of a few bytes) is a safe
+ * storage_size for that workload.
+ * @param parser The parser instance
+ * @return Bytes in use, or 0 if the parser does not use caller storage
+ */
+size_t arg_parser_storage_used(const arg_parser_t *parser);
+
 /**
  * Get parsed argument result by long name
  * @param parser The parser instance
@@ -193,6 +782,84 @@ int arg_parser_get_int(arg_parser_t *parser, const char *long_name);
  */
 float arg_parser_get_float(arg_parser_t *parser, const char *long_name);
 
+/**
+ * Get 64-bit integer value (convenience function)
+ * @param parser The parser instance
+ * @param long_name The long name of the argument
+ * @return The value, or 0 if not found
+ */
+int64_t arg_parser_get_int64(arg_parser_t *parser, const char *long_name);
+
+/**
+ * Get 64-bit unsigned integer value (convenience function)
+ * @param parser The parser instance
+ * @param long_name The long name of the argument
+ * @return The value, or 0 if not found
+ */
+uint64_t arg_parser_get_uint64(arg_parser_t *parser, const char *long_name);
+
+/**
+ * Get double value (convenience function)
+ * @param parser The parser instance
+ * @param long_name The long name of the argument
+ * @return The value, or 0.0 if not found
+ */
+double arg_parser_get_double(arg_parser_t *parser, const char *long_name);
+
+/**
+ * Get byte size value (convenience function)
+ * @param parser The parser instance
+ * @param long_name The long name of the argument
+ * @return The byte count, or 0 if not found
+ */
+uint64_t arg_parser_get_size(arg_parser_t *parser, const char *long_name);
+
+/**
+ * Get duration value in nanoseconds (convenience function)
+ * @param parser The parser instance
+ * @param long_name The long name of the argument
+ * @return The duration, or 0 if not found
+ */
+int64_t arg_parser_get_duration(arg_parser_t *parser, const char *long_name);
+
+/**
+ * Get range list value (convenience function)
+ * @param parser The parser instance
+ * @param long_name The long name of the argument
+ * @return The list (owned by the parser), or NULL if not found or empty
+ */
+const arg_range_list_t *arg_parser_get_range_list(arg_parser_t *parser, const char *long_name);
+
+/**
+ * Get 64-bit integer list values (convenience function)
+ * @param parser The parser instance
+ * @param long_name The long name of the argument
+ * @param count Output for the number of values
+ * @return The values (owned by the parser), or NULL if there are none
+ */
+const int64_t *arg_parser_get_int64_list(arg_parser_t *parser, const char *long_name,
+                                         size_t *count);
+
+/**
+ * Get double list values (convenience function)
+ * @param parser The parser instance
+ * @param long_name The long name of the argument
+ * @param count Output for the number of values
+ * @return The values (owned by the parser), or NULL if there are none
+ */
+const double *arg_parser_get_double_list(arg_parser_t *parser, const char *long_name,
+                                         size_t *count);
+
+/**
+ * Get string list values (convenience function)
+ * @param parser The parser instance
+ * @param long_name The long name of the argument
+ * @param count Output for the number of values
+ * @return The values (owned by the parser), or NULL if there are none
+ */
+const arg_string_view_t *arg_parser_get_string_list(arg_parser_t *parser,
+                                                    const char *long_name, size_t *count);
+
 /**
  * Check if an argument was explicitly set by the user
  * @param parser The parser instance
@@ -201,6 +868,196 @@ float arg_parser_get_float(arg_parser_t *parser, const char *long_name);
  */
 bool arg_parser_is_set(arg_parser_t *parser, const char *long_name);
 
+/**
+ * Parse command line arguments, collecting every error instead of printing
+ * Parsing continues past unknown arguments, and all results are validated
+ * so validation failures are reported up front (they are then not printed
+ * again by the getters). Nothing is written to stderr.
+ * @param parser The parser instance
+ * @param argc Argument count from main()
+ * @param argv Argument vector from main()
+ * @param errors Caller buffer receiving the first `capacity` errors
+ * @param capacity Number of entries in errors
+ * @param error_count Output for the total number of errors, may exceed capacity
+ * @return 0 if there were no errors, -1 otherwise
+ */
+int arg_parser_parse_with_errors(arg_parser_t *parser, int argc, char **argv,
+                                 arg_error_t *errors, size_t capacity,
+                                 size_t *error_count);
+
+/**
+ * Format an error as a human-readable message
+ * Formatting only happens here; collecting errors never builds text.
+ * Error fields reference argv and parser results, so format before either
+ * goes away.
+ * @param error The error to describe
+ * @param buffer Destination buffer (can be NULL if size is 0)
+ * @param size Size of buffer
+ * @return Length of the full message as with snprintf, or -1 on error
+ */
+int arg_error_format(const arg_error_t *error, char *buffer, size_t size);
+
+/**
+ * Get a stable handle for an argument, for use with the *_h getters
+ * Resolve handles once after registration; handle getters do no name lookup.
+ * Like every function that takes a long_name, short names are not accepted.
+ * @param parser The parser instance
+ * @param long_name The long name of the argument
+ * @return The handle, or ARG_HANDLE_INVALID if not found
+ */
+arg_handle_t arg_parser_get_handle(const arg_parser_t *parser, const char *long_name);
+
+/**
+ * Get parsed argument result by handle
+ * @param parser The parser instance
+ * @param handle Handle from arg_parser_get_handle()
+ * @return Pointer to result, or NULL if the handle is invalid or validation failed
+ */
+arg_result_t *arg_parser_get_h(arg_parser_t *parser, arg_handle_t handle);
+
+/**
+ * Get flag value by handle
+ * @param parser The parser instance
+ * @param handle Handle from arg_parser_get_handle()
+ * @return The flag value, or false if not found
+ */
+bool arg_parser_get_flag_h(arg_parser_t *parser, arg_handle_t handle);
+
+/**
+ * Get string value by handle
+ * @param parser The parser instance
+ * @param handle Handle from arg_parser_get_handle()
+ * @return The string value, or NULL if not found
+ */
+const char *arg_parser_get_string_h(arg_parser_t *parser, arg_handle_t handle);
+
+/**
+ * Get integer value by handle
+ * @param parser The parser instance
+ * @param handle Handle from arg_parser_get_handle()
+ * @return The integer value, or 0 if not found
+ */
+int arg_parser_get_int_h(arg_parser_t *parser, arg_handle_t handle);
+
+/**
+ * Get float value by handle
+ * @param parser The parser instance
+ * @param handle Handle from arg_parser_get_handle()
+ * @return The float value, or 0.0f if not found
+ */
+float arg_parser_get_float_h(arg_parser_t *parser, arg_handle_t handle);
+
+/**
+ * Get 64-bit integer value by handle
+ * @param parser The parser instance
+ * @param handle Handle from arg_parser_get_handle()
+ * @return The value, or 0 if not found
+ */
+int64_t arg_parser_get_int64_h(arg_parser_t *parser, arg_handle_t handle);
+
+/**
+ * Get 64-bit unsigned integer value by handle
+ * @param parser The parser instance
+ * @param handle Handle from arg_parser_get_handle()
+ * @return The value, or 0 if not found
+ */
+uint64_t arg_parser_get_uint64_h(arg_parser_t *parser, arg_handle_t handle);
+
+/**
+ * Get double value by handle
+ * @param parser The parser instance
+ * @param handle Handle from arg_parser_get_handle()
+ * @return The value, or 0.0 if not found
+ */
+double arg_parser_get_double_h(arg_parser_t *parser, arg_handle_t handle);
+
+/**
+ * Get byte size value by handle
+ * @param parser The parser instance
+ * @param handle Handle from arg_parser_get_handle()
+ * @return The byte count, or 0 if not found
+ */
+uint64_t arg_parser_get_size_h(arg_parser_t *parser, arg_handle_t handle);
+
+/**
+ * Get duration value in nanoseconds by handle
+ * @param parser The parser instance
+ * @param handle Handle from arg_parser_get_handle()
+ * @return The duration, or 0 if not found
+ */
+int64_t arg_parser_get_duration_h(arg_parser_t *parser, arg_handle_t handle);
+
+/**
+ * Get range list value by handle
+ * @param parser The parser instance
+ * @param handle Handle from arg_parser_get_handle()
+ * @return The list (owned by the parser), or NULL if not found or empty
+ */
+const arg_range_list_t *arg_parser_get_range_list_h(arg_parser_t *parser, arg_handle_t handle);
+
+/**
+ * Get 64-bit integer list values by handle
+ * @param parser The parser instance
+ * @param handle Handle from arg_parser_get_handle()
+ * @param count Output for the number of values
+ * @return The values (owned by the parser), or NULL if there are none
+ */
+const int64_t *arg_parser_get_int64_list_h(arg_parser_t *parser, arg_handle_t handle,
+                                           size_t *count);
+
+/**
+ * Get double list values by handle
+ * @param parser The parser instance
+ * @param handle Handle from arg_parser_get_handle()
+ * @param count Output for the number of values
+ * @return The values (owned by the parser), or NULL if there are none
+ */
+const double *arg_parser_get_double_list_h(arg_parser_t *parser, arg_handle_t handle,
+                                           size_t *count);
+
+/**
+ * Get string list values by handle
+ * @param parser The parser instance
+ * @param handle Handle from arg_parser_get_handle()
+ * @param count Output for the number of values
+ * @return The values (owned by the parser), or NULL if there are none
+ */
+const arg_string_view_t *arg_parser_get_string_list_h(arg_parser_t *parser,
+                                                      arg_handle_t handle, size_t *count);
+
+/**
+ * Check whether a value is in a range list
+ * @param list The list, can be NULL (empty)
+ * @param value The value to look up
+ * @return true if value is a member
+ */
+bool arg_range_list_contains(const arg_range_list_t *list, uint64_t value);
+
+/**
+ * Find the smallest member of a range list that is >= from
+ * Iterate with: for (int64_t v = arg_range_list_next(list, 0); v >= 0;
+ * v = arg_range_list_next(list, (uint64_t)v + 1))
+ * @param list The list, can be NULL (empty)
+ * @param from Lower bound of the search
+ * @return The member, or -1 if there is none
+ */
+int64_t arg_range_list_next(const arg_range_list_t *list, uint64_t from);
+
+/**
+ * Get the number of members in a range list
+ * @param list The list, can be NULL (empty)
+ * @return The member count
+ */
+size_t arg_range_list_count(const arg_range_list_t *list);
+
+/**
+ * Check if an argument was explicitly set by the user, by handle
+ * @param parser The parser instance
+ * @param handle Handle from arg_parser_get_handle()
+ * @return true if set, false otherwise
+ */
+bool arg_parser_is_set_h(arg_parser_t *parser, arg_handle_t handle);
+
 /**
  * Get positional arguments (non-option arguments)
  * @param parser The parser instance
@@ -209,6 +1066,65 @@ bool arg_parser_is_set(arg_parser_t *parser, const char *long_name);
  */
 char **arg_parser_get_positional(const arg_parser_t *parser, size_t *count);
 
+/**
+ * One command line for arg_batch_parse()
+ */
+typedef struct {
+    int argc;
+    char **argv;
+} arg_batch_input_t;
+
+/**
+ * Outcome of one batch record
+ */
+typedef struct {
+    arg_error_t error;           // error.code is ARG_OK for accepted records
+    size_t positional_offset;    // First positional in arg_batch_result_t.positionals
+    size_t positional_count;
+} arg_batch_record_t;
+
+/**
+ * Batch parse output, stored contiguously
+ * Values are laid out one row per record in definition order, so the
+ * value for record r and handle h is values[r * definition_count + h].
+ * Values are only meaningful for records whose error.code is ARG_OK.
+ * Values that cannot borrow from argv (range lists, list options) and
+ * validator messages in error.detail live in storage, which is released
+ * together with the result.
+ */
+typedef struct {
+    size_t record_count;
+    size_t definition_count;
+    arg_batch_record_t *records; // One per input
+    arg_value_t *values;         // record_count x definition_count
+    bool *is_set;                // Same layout as values
+    char **positionals;          // Positionals of all records
+    struct arg_arena_block *storage; // Blocks holding parsed values
+    arg_allocator_t allocator;   // Owner of the buffers above
+} arg_batch_result_t;
+
+/**
+ * Parse many command lines against one spec on a pool of worker threads
+ * Every record is parsed with the semantics of arg_parser_parse() and then
+ * fully validated. Nothing is printed: each record carries its own error.
+ * String values and positionals point into the input argv arrays, which
+ * must outlive the result.
+ * @param spec The spec to parse against, typically from arg_spec_compile()
+ * @param inputs The command lines; argv[0] of each is skipped
+ * @param count Number of command lines
+ * @param threads Worker thread count, or 0 for one per online CPU
+ * @param result Output, release with arg_batch_result_free()
+ * @return 0 on success (even if records were rejected), -1 on error
+ */
+int arg_batch_parse(const arg_spec_t *spec, const arg_batch_input_t *inputs,
+                    size_t count, unsigned threads, arg_batch_result_t *result);
+
+/**
+ * Free the buffers of a batch result
+ * @param result The result to free
+ */
+void arg_batch_result_free(arg_batch_result_t *result);
+
 /**
  * Print usage/help message to stdout
  * @param parser The parser instance
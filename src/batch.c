@@ -0,0 +1,298 @@
+#include "../includes/program_arguments.h"
+#include "internal.h"
+#include "memory.h"
+#include "range_list.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#define BATCH_CHUNK_SIZE 64
+#define MAX_BATCH_THREADS 256
+
+/**
+ * State shared by all workers of one batch
+ */
+typedef struct {
+    const arg_spec_t *spec;
+    const arg_batch_input_t *inputs;
+    arg_batch_result_t *result;
+    atomic_size_t next;        // First record of the next unclaimed chunk
+    atomic_size_t processed;   // Records parsed so far
+    pthread_mutex_t storage_lock; // Guards result->storage
+} batch_job_t;
+
+/**
+ * Helper function to copy a value the worker parser owns into storage
+ * Returns false if storage is exhausted
+ */
+static bool keep_value(arg_memory_t *storage, arg_type_t type, arg_value_t *value) {
+    if (type == ARG_TYPE_RANGE_LIST && value->range_list) {
+        size_t size = arg_range_list_size(value->range_list);
+        void *copy = arg_memory_alloc(storage, size);
+        if (!copy) {
+            return false;
+        }
+        value->range_list = arg_range_list_copy_to(copy, value->range_list);
+    }
+    if ((type == ARG_TYPE_INT64_LIST || type == ARG_TYPE_DOUBLE_LIST ||
+         type == ARG_TYPE_STRING_LIST) && value->list) {
+        // Items only; string views borrow from the inputs like strings do
+        size_t item_size = type == ARG_TYPE_STRING_LIST ? sizeof(arg_string_view_t)
+                                                        : sizeof(int64_t);
+        size_t items_size = value->list->count * item_size;
+        arg_list_t *copy = (arg_list_t *)arg_memory_alloc(storage, sizeof(arg_list_t) + items_size);
+        if (!copy) {
+            return false;
+        }
+        memset(copy, 0, sizeof(*copy));
+        copy->items = copy + 1;
+        copy->count = value->list->count;
+        copy->capacity = value->list->count;
+        memcpy(copy->items, value->list->items, items_size);
+        value->list = copy;
+    }
+    return true;
+}
+
+/**
+ * Helper function to copy a validator message into storage
+ * The worker parser frees its messages on the next reset. If storage is
+ * exhausted the detail is dropped, which only shortens the formatted error.
+ */
+static const char *keep_detail(arg_memory_t *storage, const char *detail) {
+    if (!detail) {
+        return NULL;
+    }
+    size_t size = strlen(detail) + 1;
+    char *copy = (char *)arg_memory_alloc(storage, size);
+    if (copy) {
+        memcpy(copy, detail, size);
+    }
+    return copy;
+}
+
+/**
+ * Helper function to parse one record and copy its outcome to the output
+ */
+static void parse_record(arg_parser_t *parser, arg_memory_t *storage,
+                         const batch_job_t *job, size_t r) {
+    const arg_batch_input_t *input = &job->inputs[r];
+    arg_batch_result_t *result = job->result;
+    arg_batch_record_t *record = &result->records[r];
+    size_t definition_count = result->definition_count;
+
+    // Keep only the first error; validate eagerly so every record carries
+    // its full verdict
+    arg_error_sink_t sink = {.errors = &record->error, .capacity = 1,
+                             .first = ARG_OK, .collect_all = false};
+    if (arg_parse_argv(parser, input->argc, input->argv, &sink) == ARG_OK) {
+        arg_validate_all(parser, &sink);
+    }
+    if (sink.count == 0) {
+        record->error = (arg_error_t){ARG_OK, -1, NULL, NULL, NULL};
+    }
+    record->error.detail = keep_detail(storage, record->error.detail);
+
+    arg_value_t *values = result->values + r * definition_count;
+    bool *is_set = result->is_set + r * definition_count;
+    for (size_t d = 0; d < definition_count; d++) {
+        if (parser->results && d < parser->result_count) {
+            values[d] = parser->results[d].value;
+            is_set[d] = parser->results[d].is_set;
+            if (is_set[d] && !keep_value(storage, job->spec->definitions[d].type, &values[d])) {
+                // Keep the first error, as the record's sink does
+                if (record->error.code == ARG_OK) {
+                    record->error = (arg_error_t){ARG_ERR_OUT_OF_MEMORY, -1,
+                                                  &job->spec->definitions[d], NULL, NULL};
+                }
+                is_set[d] = false;
+                values[d] = job->spec->definitions[d].default_value;
+            }
+        } else {
+            values[d] = job->spec->definitions[d].default_value;
+            is_set[d] = false;
+        }
+    }
+
+    record->positional_count = parser->positional_count;
+    if (parser->positional_count > 0) {
+        memcpy(result->positionals + record->positional_offset, parser->positional_args,
+               parser->positional_count * sizeof(char *));
+    }
+}
+
+/**
+ * Worker loop: claim chunks of records until none are left
+ */
+static void *batch_worker(void *arg) {
+    batch_job_t *job = (batch_job_t *)arg;
+
+    // Values borrow from the inputs; errors go to the records, not stderr
+    arg_parser_options_t options = {0};
+    options.flags = ARG_PARSER_BORROW_ARGV | ARG_PARSER_QUIET;
+    options.allocator = job->spec->allocator;
+
+    arg_parser_t *parser = arg_parser_create_for_spec(job->spec, &options);
+    if (!parser) {
+        return NULL;
+    }
+
+    // Owned values are copied out of the parser, which reuses its memory
+    arg_parser_options_t storage_options = {0};
+    storage_options.flags = ARG_PARSER_ARENA;
+    storage_options.allocator = job->spec->allocator;
+    arg_memory_t storage;
+    arg_memory_init(&storage, &storage_options);
+
+    size_t count = job->result->record_count;
+    for (;;) {
+        size_t start = atomic_fetch_add(&job->next, BATCH_CHUNK_SIZE);
+        if (start >= count) {
+            break;
+        }
+        size_t end = count - start < BATCH_CHUNK_SIZE ? count : start + BATCH_CHUNK_SIZE;
+        for (size_t r = start; r < end; r++) {
+            parse_record(parser, &storage, job, r);
+        }
+        atomic_fetch_add(&job->processed, end - start);
+    }
+
+    pthread_mutex_lock(&job->storage_lock);
+    arg_memory_transfer(&storage, &job->result->storage);
+    pthread_mutex_unlock(&job->storage_lock);
+
+    arg_parser_destroy(parser);
+    return NULL;
+}
+
+/**
+ * Helper function to compute a[0] * b + c without overflow
+ */
+static bool checked_size(size_t a, size_t b, size_t c, size_t *out) {
+    if (b != 0 && a > (SIZE_MAX - c) / b) {
+        return false;
+    }
+    *out = a * b + c;
+    return true;
+}
+
+/**
+ * Parse many command lines against one spec on a pool of worker threads
+ */
+int arg_batch_parse(const arg_spec_t *spec, const arg_batch_input_t *inputs,
+                    size_t count, unsigned threads, arg_batch_result_t *result) {
+    if (!spec || !result || (count > 0 && !inputs)) {
+        return -1;
+    }
+    memset(result, 0, sizeof(*result));
+
+    // Every record may contribute at most argc - 1 positionals
+    size_t positional_total = 0;
+    for (size_t r = 0; r < count; r++) {
+        if (inputs[r].argc > 1) {
+            positional_total += (size_t)inputs[r].argc - 1;
+        }
+    }
+
+    // One block: records, values, positionals, then the is_set flags
+    size_t definition_count = spec->definition_count;
+    size_t cells;
+    size_t records_size, values_size, positionals_size, total;
+    if (!checked_size(count, definition_count, 0, &cells) ||
+        !checked_size(count, sizeof(arg_batch_record_t), 0, &records_size) ||
+        !checked_size(cells, sizeof(arg_value_t), records_size, &values_size) ||
+        !checked_size(positional_total, sizeof(char *), values_size, &positionals_size) ||
+        !checked_size(cells, sizeof(bool), positionals_size, &total)) {
+        return -1;
+    }
+
+    arg_parser_options_t options = {0};
+    options.allocator = spec->allocator;
+    arg_memory_t memory;
+    arg_memory_init(&memory, &options);
+
+    unsigned char *block = (unsigned char *)arg_memory_alloc(&memory, total);
+    if (!block) {
+        return -1;
+    }
+
+    result->record_count = count;
+    result->definition_count = definition_count;
+    result->records = (arg_batch_record_t *)block;
+    result->values = (arg_value_t *)(block + records_size);
+    result->positionals = (char **)(block + values_size);
+    result->is_set = (bool *)(block + positionals_size);
+    result->allocator = memory.allocator;
+
+    size_t offset = 0;
+    for (size_t r = 0; r < count; r++) {
+        result->records[r].positional_offset = offset;
+        result->records[r].positional_count = 0;
+        if (inputs[r].argc > 1) {
+            offset += (size_t)inputs[r].argc - 1;
+        }
+    }
+
+    batch_job_t job;
+    job.spec = spec;
+    job.inputs = inputs;
+    job.result = result;
+    atomic_init(&job.next, 0);
+    atomic_init(&job.processed, 0);
+    pthread_mutex_init(&job.storage_lock, NULL);
+
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (unsigned)online : 1;
+    }
+    size_t chunks = (count + BATCH_CHUNK_SIZE - 1) / BATCH_CHUNK_SIZE;
+    if (threads > chunks) {
+        threads = chunks > 0 ? (unsigned)chunks : 1;
+    }
+    if (threads > MAX_BATCH_THREADS) {
+        threads = MAX_BATCH_THREADS;
+    }
+
+    // The calling thread works too, so a failed spawn only costs throughput
+    pthread_t workers[MAX_BATCH_THREADS];
+    unsigned started = 0;
+    for (unsigned t = 1; t < threads; t++) {
+        if (pthread_create(&workers[started], NULL, batch_worker, &job) == 0) {
+            started++;
+        }
+    }
+    batch_worker(&job);
+    for (unsigned t = 0; t < started; t++) {
+        pthread_join(workers[t], NULL);
+    }
+    pthread_mutex_destroy(&job.storage_lock);
+
+    // Workers that could not create a parser leave records unclaimed
+    if (atomic_load(&job.processed) != count) {
+        arg_batch_result_free(result);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Free the buffers of a batch result
+ */
+void arg_batch_result_free(arg_batch_result_t *result) {
+    if (!result || !result->records) {
+        return;
+    }
+
+    arg_parser_options_t options = {0};
+    options.flags = ARG_PARSER_ARENA;
+    options.allocator = result->allocator;
+    arg_memory_t storage;
+    arg_memory_init(&storage, &options);
+    storage.arena = result->storage;
+    arg_memory_release(&storage);
+
+    result->allocator.deallocate(result->records, result->allocator.context);
+    memset(result, 0, sizeof(*result));
+}
@@ -0,0 +1,339 @@
+#include "constraint.h"
+#include <inttypes.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
+
+typedef bool (*int64_scanner_fn)(const int64_t *items, size_t count, int64_t min, int64_t max);
+typedef bool (*double_scanner_fn)(const double *items, size_t count, double min, double max);
+
+/**
+ * Helper function to tell whether any integer is outside [min, max]
+ * Branch-free, so a passing list costs one compare pair per item
+ */
+static bool int64_any_outside_scalar(const int64_t *items, size_t count, int64_t min, int64_t max) {
+    bool outside = false;
+    for (size_t i = 0; i < count; i++) {
+        outside |= (items[i] < min) | (items[i] > max);
+    }
+    return outside;
+}
+
+/**
+ * Helper function to tell whether any floating-point value is outside
+ * [min, max]; NaN is outside every range
+ */
+static bool double_any_outside_scalar(const double *items, size_t count, double min, double max) {
+    bool outside = false;
+    for (size_t i = 0; i < count; i++) {
+        outside |= !(items[i] >= min) | !(items[i] <= max);
+    }
+    return outside;
+}
+
+#ifdef HAVE_X86_SIMD
+/**
+ * Helper function to scan integers four at a time with AVX2
+ * SSE2 has no 64-bit compare, so there is no SSE2 variant
+ */
+__attribute__((target("avx2")))
+static bool int64_any_outside_avx2(const int64_t *items, size_t count, int64_t min, int64_t max) {
+    __m256i low = _mm256_set1_epi64x(min);
+    __m256i high = _mm256_set1_epi64x(max);
+    __m256i outside = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(items + i));
+        outside = _mm256_or_si256(outside, _mm256_cmpgt_epi64(low, v));
+        outside = _mm256_or_si256(outside, _mm256_cmpgt_epi64(v, high));
+    }
+    return !_mm256_testz_si256(outside, outside) ||
+           int64_any_outside_scalar(items + i, count - i, min, max);
+}
+
+/**
+ * Helper function to scan floating-point values four at a time with AVX2
+ * The unordered compares count NaN as outside
+ */
+__attribute__((target("avx2")))
+static bool double_any_outside_avx2(const double *items, size_t count, double min, double max) {
+    __m256d low = _mm256_set1_pd(min);
+    __m256d high = _mm256_set1_pd(max);
+    __m256d outside = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d v = _mm256_loadu_pd(items + i);
+        outside = _mm256_or_pd(outside, _mm256_cmp_pd(v, low, _CMP_NGE_UQ));
+        outside = _mm256_or_pd(outside, _mm256_cmp_pd(v, high, _CMP_NLE_UQ));
+    }
+    return _mm256_movemask_pd(outside) != 0 ||
+           double_any_outside_scalar(items + i, count - i, min, max);
+}
+#endif
+
+static int64_scanner_fn int64_any_outside = int64_any_outside_scalar;
+static double_scanner_fn double_any_outside = double_any_outside_scalar;
+static pthread_once_t scanner_once = PTHREAD_ONCE_INIT;
+
+/**
+ * Helper function to pick the widest list scanners the CPU supports
+ */
+static void select_scanners(void) {
+#ifdef HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        int64_any_outside = int64_any_outside_avx2;
+        double_any_outside = double_any_outside_avx2;
+    }
+#endif
+}
+
+/**
+ * Helper function to find the first integer outside [min, max]
+ * The offender is only looked for once a failure is known.
+ * Returns count if every item is in range
+ */
+static size_t int64_outside(const int64_t *items, size_t count, int64_t min, int64_t max) {
+    pthread_once(&scanner_once, select_scanners);
+    if (!int64_any_outside(items, count, min, max)) {
+        return count;
+    }
+
+    size_t i = 0;
+    while (items[i] >= min && items[i] <= max) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * Helper function to find the first floating-point value outside [min, max]
+ */
+static size_t double_outside(const double *items, size_t count, double min, double max) {
+    pthread_once(&scanner_once, select_scanners);
+    if (!double_any_outside(items, count, min, max)) {
+        return count;
+    }
+
+    size_t i = 0;
+    while (items[i] >= min && items[i] <= max) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * Helper function to check integers against the range
+ */
+static bool check_int64(const arg_constraint_t *constraint, const int64_t *items, size_t count,
+                        char *message, size_t size) {
+    if (!(constraint->kinds & ARG_CONSTRAINT_RANGE)) {
+        return true;
+    }
+
+    int64_t min = constraint->range.min.integer;
+    int64_t max = constraint->range.max.integer;
+    size_t i = int64_outside(items, count, min, max);
+    if (i == count) {
+        return true;
+    }
+
+    if (min == INT64_MIN) {
+        snprintf(message, size, "must be at most %" PRId64 ", got %" PRId64, max, items[i]);
+    } else if (max == INT64_MAX) {
+        snprintf(message, size, "must be at least %" PRId64 ", got %" PRId64, min, items[i]);
+    } else {
+        snprintf(message, size, "must be between %" PRId64 " and %" PRId64 ", got %" PRId64,
+                 min, max, items[i]);
+    }
+    return false;
+}
+
+/**
+ * Helper function to check an unsigned integer against the range
+ * There are no unsigned list options, so this only sees single values
+ */
+static bool check_uint64(const arg_constraint_t *constraint, uint64_t value,
+                         char *message, size_t size) {
+    if (!(constraint->kinds & ARG_CONSTRAINT_RANGE)) {
+        return true;
+    }
+
+    uint64_t min = constraint->range.min.uinteger;
+    uint64_t max = constraint->range.max.uinteger;
+    if (value >= min && value <= max) {
+        return true;
+    }
+
+    if (min == 0) {
+        snprintf(message, size, "must be at most %" PRIu64 ", got %" PRIu64, max, value);
+    } else if (max == UINT64_MAX) {
+        snprintf(message, size, "must be at least %" PRIu64 ", got %" PRIu64, min, value);
+    } else {
+        snprintf(message, size, "must be between %" PRIu64 " and %" PRIu64 ", got %" PRIu64,
+                 min, max, value);
+    }
+    return false;
+}
+
+/**
+ * Helper function to format a number for a range message
+ * Float options get the shortest text that reads back as the same float,
+ * so a bound and a value that differ as floats never print alike.
+ */
+static void format_number(char *buffer, size_t size, uint8_t type, double value) {
+    if (type != ARG_TYPE_FLOAT) {
+        snprintf(buffer, size, "%g", value);
+        return;
+    }
+    for (int precision = 6; precision < 9; precision++) {
+        snprintf(buffer, size, "%.*g", precision, value);
+        if ((float)strtod(buffer, NULL) == (float)value) {
+            return;
+        }
+    }
+    snprintf(buffer, size, "%.9g", value);
+}
+
+/**
+ * Helper function to check floating-point values against the range
+ * Float values arrive widened to double; their bounds are already rounded
+ * to float, so the comparison is the one floats would make
+ */
+static bool check_double(const arg_constraint_t *constraint, const double *items, size_t count,
+                         char *message, size_t size) {
+    if (!(constraint->kinds & ARG_CONSTRAINT_RANGE)) {
+        return true;
+    }
+
+    double min = constraint->range.min.floating;
+    double max = constraint->range.max.floating;
+    size_t i = double_outside(items, count, min, max);
+    if (i == count) {
+        return true;
+    }
+
+    char low[32], high[32], got[32];
+    format_number(low, sizeof(low), constraint->type, min);
+    format_number(high, sizeof(high), constraint->type, max);
+    format_number(got, sizeof(got), constraint->type, items[i]);
+    if (min == -INFINITY) {
+        snprintf(message, size, "must be at most %s, got %s", high, got);
+    } else if (max == INFINITY) {
+        snprintf(message, size, "must be at least %s, got %s", low, got);
+    } else {
+        snprintf(message, size, "must be between %s and %s, got %s", low, high, got);
+    }
+    return false;
+}
+
+/**
+ * Helper function to write the "must be one of" message
+ */
+static void choices_message(const arg_constraint_t *constraint, const char *data, size_t length,
+                            char *message, size_t size) {
+    int written = snprintf(message, size, "must be one of ");
+    for (size_t c = 0; c < constraint->choice_count; c++) {
+        if (written < 0 || (size_t)written >= size) {
+            return;
+        }
+        int n = snprintf(message + written, size - (size_t)written, "%s%s",
+                         c > 0 ? ", " : "", constraint->text.choices[c]);
+        written = n < 0 ? n : written + n;
+    }
+    if (written >= 0 && (size_t)written < size) {
+        snprintf(message + written, size - (size_t)written, ", got '%.*s'", (int)length, data);
+    }
+}
+
+/**
+ * Helper function to check one string against the prefix, suffix and choices
+ * The string need not be NUL-terminated, so list items are checked in place
+ */
+static bool check_string(const arg_constraint_t *constraint, const char *data, size_t length,
+                         char *message, size_t size) {
+    if ((constraint->kinds & ARG_CONSTRAINT_PREFIX) &&
+        (length < constraint->text.prefix_length ||
+         memcmp(data, constraint->text.prefix, constraint->text.prefix_length) != 0)) {
+        snprintf(message, size, "must start with '%s', got '%.*s'",
+                 constraint->text.prefix, (int)length, data);
+        return false;
+    }
+
+    if ((constraint->kinds & ARG_CONSTRAINT_SUFFIX) &&
+        (length < constraint->text.suffix_length ||
+         memcmp(data + length - constraint->text.suffix_length, constraint->text.suffix,
+                constraint->text.suffix_length) != 0)) {
+        snprintf(message, size, "must end with '%s', got '%.*s'",
+                 constraint->text.suffix, (int)length, data);
+        return false;
+    }
+
+    if (constraint->kinds & ARG_CONSTRAINT_CHOICES) {
+        for (size_t c = 0; c < constraint->choice_count; c++) {
+            const char *choice = constraint->text.choices[c];
+            if (strncmp(choice, data, length) == 0 && choice[length] == '\0') {
+                return true;
+            }
+        }
+        choices_message(constraint, data, length, message, size);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Check a parsed value against its constraints, formatting a message on failure
+ */
+bool arg_constraint_check_value(const arg_constraint_t *constraint, arg_value_t value,
+                                char *message, size_t size) {
+    switch ((arg_type_t)constraint->type) {
+        case ARG_TYPE_INT: {
+            int64_t item = value.integer;
+            return check_int64(constraint, &item, 1, message, size);
+        }
+        case ARG_TYPE_INT64:
+        case ARG_TYPE_DURATION:
+            return check_int64(constraint, &value.integer64, 1, message, size);
+        case ARG_TYPE_UINT64:
+        case ARG_TYPE_SIZE:
+            return check_uint64(constraint, value.uinteger64, message, size);
+        case ARG_TYPE_FLOAT: {
+            double item = value.floating;
+            return check_double(constraint, &item, 1, message, size);
+        }
+        case ARG_TYPE_DOUBLE:
+            return check_double(constraint, &value.floating64, 1, message, size);
+        case ARG_TYPE_STRING:
+            return !value.string ||
+                   check_string(constraint, value.string, strlen(value.string), message, size);
+        case ARG_TYPE_INT64_LIST:
+            return !value.list ||
+                   check_int64(constraint, (const int64_t *)value.list->items, value.list->count,
+                               message, size);
+        case ARG_TYPE_DOUBLE_LIST:
+            return !value.list ||
+                   check_double(constraint, (const double *)value.list->items, value.list->count,
+                                message, size);
+        case ARG_TYPE_STRING_LIST:
+            if (!value.list) {
+                return true;
+            }
+            for (size_t i = 0; i < value.list->count; i++) {
+                const arg_string_view_t *item = &((const arg_string_view_t *)value.list->items)[i];
+                if (!check_string(constraint, item->data, item->length, message, size)) {
+                    return false;
+                }
+            }
+            return true;
+        default:
+            return true;
+    }
+}
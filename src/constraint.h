@@ -0,0 +1,115 @@
+#ifndef PROGRAM_ARGUMENTS_CONSTRAINT_H
+#define PROGRAM_ARGUMENTS_CONSTRAINT_H
+
+#include "../includes/program_arguments.h"
+#include <stdint.h>
+
+/**
+ * Declarative constraints
+ *
+ * Range, choice and prefix/suffix checks attached at registration and
+ * evaluated in one pass over the results right after parsing, without a
+ * validator call. Bounds are kept in the widest type of the option's value
+ * class, so one comparison covers int, int64 and duration (or uint64 and
+ * size, or float and double), and list options check every item. Bounds
+ * of float options are stored rounded to float, so comparing a float
+ * value against them in double precision matches comparing floats.
+ */
+
+#define ARG_CONSTRAINT_RANGE   (1u << 0) // Value within [min, max]
+#define ARG_CONSTRAINT_CHOICES (1u << 1) // String equals one of choices
+#define ARG_CONSTRAINT_PREFIX  (1u << 2) // String starts with prefix
+#define ARG_CONSTRAINT_SUFFIX  (1u << 3) // String ends with suffix
+
+/**
+ * Range bound, read as the member matching the option's value class
+ */
+typedef union {
+    int64_t integer;
+    uint64_t uinteger;
+    double floating;
+} arg_bound_t;
+
+/**
+ * Constraints of one definition, indexed like the definitions
+ * Numeric options only ever carry a range and string options only the
+ * text checks, so the two share storage. Choices, prefix and suffix are
+ * referenced, not copied, like descriptions.
+ */
+typedef struct arg_constraint {
+    uint8_t kinds;           // ARG_CONSTRAINT_* bits, 0 if unconstrained
+    uint8_t type;            // arg_type_t of the definition, so checks never read it
+    uint32_t choice_count;
+    union {
+        struct {
+            arg_bound_t min;
+            arg_bound_t max;
+        } range;
+        struct {
+            const char *const *choices;
+            const char *prefix;
+            const char *suffix;
+            uint32_t prefix_length;
+            uint32_t suffix_length;
+        } text;
+    };
+} arg_constraint_t;
+
+/**
+ * Check a parsed value against its constraints, formatting a message on failure
+ * @param constraint The constraints of the value's definition
+ * @param value The parsed value
+ * @param message Buffer for a message, only written on failure
+ * @param size Size of the message buffer
+ * @return true if the value satisfies every constraint
+ */
+bool arg_constraint_check_value(const arg_constraint_t *constraint, arg_value_t value,
+                                char *message, size_t size);
+
+/**
+ * Check a parsed value against its constraints
+ * Scalar ranges that pass are answered inline with two compares; lists,
+ * strings and every failure go through arg_constraint_check_value()
+ */
+static inline bool arg_constraint_check(const arg_constraint_t *constraint, arg_value_t value,
+                                        char *message, size_t size) {
+    switch (constraint->type) {
+        case ARG_TYPE_INT:
+            if (value.integer >= constraint->range.min.integer &&
+                value.integer <= constraint->range.max.integer) {
+                return true;
+            }
+            break;
+        case ARG_TYPE_INT64:
+        case ARG_TYPE_DURATION:
+            if (value.integer64 >= constraint->range.min.integer &&
+                value.integer64 <= constraint->range.max.integer) {
+                return true;
+            }
+            break;
+        case ARG_TYPE_UINT64:
+        case ARG_TYPE_SIZE:
+            if (value.uinteger64 >= constraint->range.min.uinteger &&
+                value.uinteger64 <= constraint->range.max.uinteger) {
+                return true;
+            }
+            break;
+        case ARG_TYPE_FLOAT:
+            if (value.floating >= constraint->range.min.floating &&
+                value.floating <= constraint->range.max.floating) {
+                return true;
+            }
+            break;
+        case ARG_TYPE_DOUBLE:
+            if (value.floating64 >= constraint->range.min.floating &&
+                value.floating64 <= constraint->range.max.floating) {
+                return true;
+            }
+            break;
+        default:
+            break;
+    }
+    return arg_constraint_check_value(constraint, value, message, size);
+}
+
+#endif //PROGRAM_ARGUMENTS_CONSTRAINT_H
@@ -0,0 +1,43 @@
+#ifndef PROGRAM_ARGUMENTS_INTERNAL_H
+#define PROGRAM_ARGUMENTS_INTERNAL_H
+
+#include "../includes/program_arguments.h"
+
+/**
+ * Parser internals shared between translation units
+ */
+
+/**
+ * Destination for parse errors
+ * The first capacity errors are stored; count keeps counting past that.
+ */
+typedef struct {
+    arg_error_t *errors;
+    size_t capacity;
+    size_t count;             // Errors reported so far
+    arg_error_code_t first;   // Code of the first error, ARG_OK if none
+    bool collect_all;         // Keep parsing after recoverable errors
+    bool fixed_storage;       // Allocation failures mean caller storage is full
+} arg_error_sink_t;
+
+/**
+ * Parse command line arguments without printing anything
+ * Errors go to the sink; unless it collects all errors, parsing stops at
+ * the first one
+ * @return ARG_OK on success, otherwise the code of the first error
+ */
+arg_error_code_t arg_parse_argv(arg_parser_t *parser, int argc, char **argv,
+                                arg_error_sink_t *sink);
+
+/**
+ * Validate every result of the last parse, reporting failures to the sink
+ */
+void arg_validate_all(arg_parser_t *parser, arg_error_sink_t *sink);
+
+/**
+ * Validate a result once, caching the outcome in the result
+ * @return true if the value is valid
+ */
+bool arg_validate_result(arg_parser_t *parser, arg_result_t *result);
+
+#endif //PROGRAM_ARGUMENTS_INTERNAL_H
@@ -0,0 +1,250 @@
+#include "memory.h"
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_ARENA_BLOCK_SIZE 16384
+#define ARENA_ALIGNMENT alignof(max_align_t)
+
+/**
+ * Arena block header, followed by the block's usable bytes
+ */
+struct arg_arena_block {
+    struct arg_arena_block *next;
+    size_t size;
+    size_t used;
+    size_t last_offset;   // Offset of the most recent allocation
+    alignas(max_align_t) unsigned char data[];
+};
+
+static void *default_allocate(size_t size, void *context) {
+    (void)context;
+    return malloc(size);
+}
+
+static void *default_reallocate(void *ptr, size_t size, void *context) {
+    (void)context;
+    return realloc(ptr, size);
+}
+
+static void default_deallocate(void *ptr, void *context) {
+    (void)context;
+    free(ptr);
+}
+
+/**
+ * Set up a memory source from parser options
+ */
+void arg_memory_init(arg_memory_t *memory, const arg_parser_options_t *options) {
+    memory->allocator.allocate = default_allocate;
+    memory->allocator.reallocate = default_reallocate;
+    memory->allocator.deallocate = default_deallocate;
+    memory->allocator.context = NULL;
+    memory->arena = NULL;
+    memory->arena_block_size = DEFAULT_ARENA_BLOCK_SIZE;
+    memory->use_arena = false;
+    memory->fixed = false;
+
+    if (!options) {
+        return;
+    }
+
+    // Caller storage becomes the one arena block; the allocator is never used
+    if (options->storage) {
+        memory->use_arena = true;
+        memory->fixed = true;
+        uintptr_t start = (uintptr_t)options->storage;
+        uintptr_t aligned = (start + alignof(struct arg_arena_block) - 1) &
+                            ~(uintptr_t)(alignof(struct arg_arena_block) - 1);
+        size_t overhead = (size_t)(aligned - start) + sizeof(struct arg_arena_block);
+        if (options->storage_size < overhead) {
+            return;
+        }
+        struct arg_arena_block *block = (struct arg_arena_block *)aligned;
+        block->next = NULL;
+        block->size = options->storage_size - overhead;
+        block->used = 0;
+        block->last_offset = 0;
+        memory->arena = block;
+        return;
+    }
+
+    // Custom allocators must supply all three callbacks
+    if (options->allocator.allocate && options->allocator.reallocate &&
+        options->allocator.deallocate) {
+        memory->allocator = options->allocator;
+    }
+    if (options->arena_block_size > 0) {
+        memory->arena_block_size = options->arena_block_size;
+    }
+    memory->use_arena = (options->flags & ARG_PARSER_ARENA) != 0;
+}
+
+/**
+ * Helper function to round a size up to the arena alignment
+ */
+static size_t align_size(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+}
+
+/**
+ * Helper function to bump-allocate from the current arena block,
+ * starting a new block when it is full
+ */
+static void *arena_alloc(arg_memory_t *memory, size_t size) {
+    if (size > SIZE_MAX - ARENA_ALIGNMENT) {
+        return NULL;
+    }
+    size = align_size(size == 0 ? 1 : size);
+
+    struct arg_arena_block *block = memory->arena;
+    if (!block || block->size - block->used < size) {
+        if (memory->fixed) {
+            return NULL;
+        }
+        size_t block_size = size > memory->arena_block_size ?
+                            size : memory->arena_block_size;
+        if (block_size > SIZE_MAX - sizeof(struct arg_arena_block)) {
+            return NULL;
+        }
+        block = memory->allocator.allocate(sizeof(struct arg_arena_block) + block_size,
+                                           memory->allocator.context);
+        if (!block) {
+            return NULL;
+        }
+        block->next = memory->arena;
+        block->size = block_size;
+        block->used = 0;
+        block->last_offset = 0;
+        memory->arena = block;
+    }
+
+    block->last_offset = block->used;
+    block->used += size;
+    return block->data + block->last_offset;
+}
+
+/**
+ * Allocate size bytes
+ */
+void *arg_memory_alloc(arg_memory_t *memory, size_t size) {
+    if (memory->use_arena) {
+        return arena_alloc(memory, size);
+    }
+    return memory->allocator.allocate(size, memory->allocator.context);
+}
+
+/**
+ * Allocate a zeroed array
+ */
+void *arg_memory_calloc(arg_memory_t *memory, size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    void *ptr = arg_memory_alloc(memory, count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+/**
+ * Resize an allocation
+ */
+void *arg_memory_realloc(arg_memory_t *memory, void *ptr, size_t old_size,
+                         size_t new_size) {
+    if (!memory->use_arena) {
+        return memory->allocator.reallocate(ptr, new_size, memory->allocator.context);
+    }
+
+    if (!ptr) {
+        return arena_alloc(memory, new_size);
+    }
+
+    // The most recent allocation can grow in place
+    struct arg_arena_block *block = memory->arena;
+    if (block && (unsigned char *)ptr == block->data + block->last_offset &&
+        new_size <= SIZE_MAX - ARENA_ALIGNMENT &&
+        block->last_offset + align_size(new_size) <= block->size) {
+        block->used = block->last_offset + align_size(new_size);
+        return ptr;
+    }
+
+    void *new_ptr = arena_alloc(memory, new_size);
+    if (!new_ptr) {
+        return NULL;
+    }
+    memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    return new_ptr;
+}
+
+/**
+ * Free an allocation
+ */
+void arg_memory_free(arg_memory_t *memory, void *ptr) {
+    if (!ptr || memory->use_arena) {
+        return;
+    }
+    memory->allocator.deallocate(ptr, memory->allocator.context);
+}
+
+/**
+ * Duplicate a string
+ */
+char *arg_memory_strdup(arg_memory_t *memory, const char *str) {
+    size_t size = strlen(str) + 1;
+    char *copy = (char *)arg_memory_alloc(memory, size);
+    if (copy) {
+        memcpy(copy, str, size);
+    }
+    return copy;
+}
+
+/**
+ * Bytes of caller storage in use
+ */
+size_t arg_memory_used(const arg_memory_t *memory) {
+    if (!memory->fixed || !memory->arena) {
+        return 0;
+    }
+    // Count the header and alignment too, so callers can size storage from it
+    const struct arg_arena_block *block = memory->arena;
+    return (size_t)(block->data - (const unsigned char *)block) + block->used;
+}
+
+/**
+ * Release all arena blocks
+ */
+void arg_memory_release(arg_memory_t *memory) {
+    // Caller storage is not ours to free
+    if (memory->fixed) {
+        return;
+    }
+
+    // Copy what we need first: memory may live inside a block
+    struct arg_arena_block *block = memory->arena;
+    arg_allocator_t allocator = memory->allocator;
+
+    while (block) {
+        struct arg_arena_block *next = block->next;
+        allocator.deallocate(block, allocator.context);
+        block = next;
+    }
+}
+
+/**
+ * Move all arena blocks onto a block list
+ */
+void arg_memory_transfer(arg_memory_t *memory, struct arg_arena_block **list) {
+    struct arg_arena_block *block = memory->arena;
+    if (!block) {
+        return;
+    }
+    while (block->next) {
+        block = block->next;
+    }
+    block->next = *list;
+    *list = memory->arena;
+    memory->arena = NULL;
+}
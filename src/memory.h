@@ -0,0 +1,68 @@
+#ifndef PROGRAM_ARGUMENTS_MEMORY_H
+#define PROGRAM_ARGUMENTS_MEMORY_H
+
+#include "../includes/program_arguments.h"
+
+/**
+ * Internal memory layer shared by the parser
+ *
+ * Every parser-owned allocation goes through an arg_memory_t. It forwards
+ * to the configured allocator callbacks, or bump-allocates from arena
+ * blocks when arena mode is enabled. In arena mode individual frees are
+ * no-ops and arg_memory_release() returns all blocks at once. Caller
+ * storage is used as a single fixed arena block: allocations that do not
+ * fit fail instead of reaching the allocator.
+ */
+
+/**
+ * Set up a memory source from parser options (NULL for stdlib defaults)
+ */
+void arg_memory_init(arg_memory_t *memory, const arg_parser_options_t *options);
+
+/**
+ * Allocate size bytes, returns NULL on failure
+ */
+void *arg_memory_alloc(arg_memory_t *memory, size_t size);
+
+/**
+ * Allocate a zeroed array, returns NULL on failure or overflow
+ */
+void *arg_memory_calloc(arg_memory_t *memory, size_t count, size_t size);
+
+/**
+ * Resize an allocation of old_size bytes to new_size bytes
+ * Returns NULL on failure, leaving ptr untouched
+ */
+void *arg_memory_realloc(arg_memory_t *memory, void *ptr, size_t old_size,
+                         size_t new_size);
+
+/**
+ * Free an allocation (no-op in arena mode)
+ */
+void arg_memory_free(arg_memory_t *memory, void *ptr);
+
+/**
+ * Duplicate a string, returns NULL on failure
+ */
+char *arg_memory_strdup(arg_memory_t *memory, const char *str);
+
+/**
+ * Bytes of caller storage in use, 0 if the memory source is not fixed
+ */
+size_t arg_memory_used(const arg_memory_t *memory);
+
+/**
+ * Release all arena blocks (no-op outside arena mode and for caller storage)
+ * The memory source must not be used afterwards; note that it may itself
+ * live inside one of the released blocks.
+ */
+void arg_memory_release(arg_memory_t *memory);
+
+/**
+ * Move all arena blocks of memory onto the front of a block list
+ * The blocks keep their contents; release them later through a memory
+ * source whose arena is the list. memory is left with no blocks.
+ */
+void arg_memory_transfer(arg_memory_t *memory, struct arg_arena_block **list);
+
+#endif //PROGRAM_ARGUMENTS_MEMORY_H
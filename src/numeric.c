@@ -0,0 +1,543 @@
+#define _GNU_SOURCE
+#include "numeric.h"
+#include <float.h>
+#include <locale.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif
+
+#if defined(__GLIBC__) || defined(__APPLE__) || defined(__FreeBSD__)
+#define HAVE_STRTOD_L 1
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define HAVE_SWAR_DIGITS 1
+#endif
+
+// Longest significand the fast path accumulates exactly in a uint64_t
+#define MAX_FAST_DIGITS 19
+// 2^53: integers up to here are exact doubles
+#define MAX_EXACT_INTEGER 9007199254740992ULL
+// Largest power of ten that is an exact double
+#define MAX_EXACT_POW10 22
+
+static const double exact_powers_of_ten[MAX_EXACT_POW10 + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static bool is_digit(char c) {
+    return (unsigned char)(c - '0') < 10;
+}
+
+/**
+ * Helper function to read the character at p, or '\0' at the end
+ */
+static char peek(const char *p, const char *end) {
+    return p < end ? *p : '\0';
+}
+
+#ifdef HAVE_SWAR_DIGITS
+/**
+ * Helper function to check that 8 bytes are all ASCII digits
+ */
+static bool is_eight_digits(uint64_t chunk) {
+    return (((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+             (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+            0x3333333333333333ULL);
+}
+
+/**
+ * Helper function to convert 8 ASCII digits in one go
+ */
+static uint32_t parse_eight_digits(uint64_t chunk) {
+    chunk = (chunk & 0x0F0F0F0F0F0F0F0FULL) * 2561 >> 8;
+    chunk = (chunk & 0x00FF00FF00FF00FFULL) * 6553601 >> 16;
+    return (uint32_t)((chunk & 0x0000FFFF0000FFFFULL) * 42949672960001ULL >> 32);
+}
+#endif
+
+/**
+ * Helper function to accumulate a run of digits into an unsigned value
+ * The run ends at the first non-digit or at end. Returns the number of
+ * characters consumed; *overflow is set if the value does not fit in
+ * 64 bits
+ */
+static size_t parse_digits(const char *p, const char *end, uint64_t *value,
+                           bool *overflow) {
+    const char *start = p;
+    uint64_t v = 0;
+    bool over = false;
+
+#ifdef HAVE_SWAR_DIGITS
+    // Eight digits per step while whole chunks remain
+    while (end - p >= 8) {
+        uint64_t chunk;
+        memcpy(&chunk, p, sizeof(chunk));
+        if (!is_eight_digits(chunk)) {
+            break;
+        }
+        over |= __builtin_mul_overflow(v, 100000000ULL, &v);
+        over |= __builtin_add_overflow(v, parse_eight_digits(chunk), &v);
+        p += 8;
+    }
+#endif
+
+    while (p < end && is_digit(*p)) {
+        over |= __builtin_mul_overflow(v, 10ULL, &v);
+        over |= __builtin_add_overflow(v, (uint64_t)(*p - '0'), &v);
+        p++;
+    }
+
+    *value = v;
+    *overflow = over;
+    return (size_t)(p - start);
+}
+
+/**
+ * Parse a decimal integer with optional sign
+ */
+arg_error_code_t arg_parse_int64(const char *str, int64_t min, int64_t max,
+                                 int64_t *out) {
+    return arg_parse_int64_n(str, strlen(str), min, max, out);
+}
+
+/**
+ * Parse a decimal integer with optional sign from the first length bytes
+ */
+arg_error_code_t arg_parse_int64_n(const char *str, size_t length, int64_t min,
+                                   int64_t max, int64_t *out) {
+    bool negative = false;
+    if (length > 0 && (*str == '-' || *str == '+')) {
+        negative = *str == '-';
+        str++;
+        length--;
+    }
+
+    uint64_t magnitude;
+    bool overflow;
+    if (length == 0 || parse_digits(str, str + length, &magnitude, &overflow) != length) {
+        return ARG_ERR_INVALID_NUMBER;
+    }
+
+    // Magnitudes up to 2^63 fit once the sign is applied
+    uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+    if (overflow || magnitude > limit) {
+        return ARG_ERR_OUT_OF_RANGE;
+    }
+
+    int64_t value = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+    if (value < min || value > max) {
+        return ARG_ERR_OUT_OF_RANGE;
+    }
+    *out = value;
+    return ARG_OK;
+}
+
+/**
+ * Parse a decimal unsigned integer
+ */
+arg_error_code_t arg_parse_uint64(const char *str, uint64_t max, uint64_t *out) {
+    if (*str == '+') {
+        str++;
+    }
+
+    uint64_t value;
+    bool overflow;
+    size_t length = strlen(str);
+    if (length == 0 || parse_digits(str, str + length, &value, &overflow) != length) {
+        return ARG_ERR_INVALID_NUMBER;
+    }
+    if (overflow || value > max) {
+        return ARG_ERR_OUT_OF_RANGE;
+    }
+    *out = value;
+    return ARG_OK;
+}
+
+#ifdef HAVE_STRTOD_L
+static locale_t c_locale;
+static pthread_once_t c_locale_once = PTHREAD_ONCE_INIT;
+
+static void create_c_locale(void) {
+    c_locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+}
+#endif
+
+/**
+ * Helper function for the slow path: correctly rounded conversion of an
+ * already validated number, independent of the current locale
+ */
+static double convert_slow(const char *str) {
+#ifdef HAVE_STRTOD_L
+    pthread_once(&c_locale_once, create_c_locale);
+    if (c_locale) {
+        return strtod_l(str, NULL, c_locale);
+    }
+#endif
+    return strtod(str, NULL);
+}
+
+/**
+ * Parse a decimal floating-point number
+ */
+arg_error_code_t arg_parse_double(const char *str, double *out) {
+    return arg_parse_double_n(str, strlen(str), out);
+}
+
+/**
+ * Parse a decimal floating-point number from the first length bytes
+ *
+ * Validation and significand extraction happen in one pass. When the
+ * significand is exact in a double and the power of ten is too (Clinger's
+ * fast path), one multiplication or division gives the correctly rounded
+ * result. Everything else goes to strtod in the C locale.
+ */
+arg_error_code_t arg_parse_double_n(const char *str, size_t length, double *out) {
+    const char *p = str;
+    const char *end = str + length;
+    bool negative = false;
+    if (peek(p, end) == '-' || peek(p, end) == '+') {
+        negative = peek(p, end) == '-';
+        p++;
+    }
+
+    uint64_t significand = 0;
+    int digits = 0;            // Significant digits accumulated
+    bool truncated = false;    // Non-zero digits beyond MAX_FAST_DIGITS
+    int exponent = 0;          // Decimal exponent adjustment
+    bool any_digit = false;
+
+    for (; is_digit(peek(p, end)); p++) {
+        any_digit = true;
+        if (digits < MAX_FAST_DIGITS) {
+            significand = significand * 10 + (uint64_t)(*p - '0');
+            digits += significand != 0;
+        } else {
+            exponent++;
+            truncated |= *p != '0';
+        }
+    }
+    if (peek(p, end) == '.') {
+        p++;
+        for (; is_digit(peek(p, end)); p++) {
+            any_digit = true;
+            if (digits < MAX_FAST_DIGITS) {
+                significand = significand * 10 + (uint64_t)(*p - '0');
+                digits += significand != 0;
+                exponent--;
+            } else {
+                truncated |= *p != '0';
+            }
+        }
+    }
+    if (!any_digit) {
+        return ARG_ERR_INVALID_NUMBER;
+    }
+
+    if (peek(p, end) == 'e' || peek(p, end) == 'E') {
+        p++;
+        bool exponent_negative = false;
+        if (peek(p, end) == '-' || peek(p, end) == '+') {
+            exponent_negative = peek(p, end) == '-';
+            p++;
+        }
+        if (!is_digit(peek(p, end))) {
+            return ARG_ERR_INVALID_NUMBER;
+        }
+        int explicit_exponent = 0;
+        for (; is_digit(peek(p, end)); p++) {
+            // Saturate: anything this large over/underflows anyway
+            if (explicit_exponent < 100000) {
+                explicit_exponent = explicit_exponent * 10 + (*p - '0');
+            }
+        }
+        exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
+    }
+    if (p != end) {
+        return ARG_ERR_INVALID_NUMBER;
+    }
+
+    double value;
+#if FLT_EVAL_METHOD == 0
+    if (!truncated && significand <= MAX_EXACT_INTEGER &&
+        exponent >= -MAX_EXACT_POW10 && exponent <= MAX_EXACT_POW10) {
+        value = (double)significand;
+        if (exponent < 0) {
+            value /= exact_powers_of_ten[-exponent];
+        } else {
+            value *= exact_powers_of_ten[exponent];
+        }
+        value = negative ? -value : value;
+    } else
+#endif
+    if (significand == 0 && !truncated) {
+        value = negative ? -0.0 : 0.0;
+    } else {
+        value = convert_slow(str);
+    }
+
+    if (isinf(value)) {
+        return ARG_ERR_OUT_OF_RANGE;
+    }
+    *out = value;
+    return ARG_OK;
+}
+
+/**
+ * Helper function for the float slow path, like convert_slow()
+ */
+static float convert_slow_float(const char *str) {
+#ifdef HAVE_STRTOD_L
+    pthread_once(&c_locale_once, create_c_locale);
+    if (c_locale) {
+        return strtof_l(str, NULL, c_locale);
+    }
+#endif
+    return strtof(str, NULL);
+}
+
+/**
+ * Parse a decimal floating-point number into a float
+ *
+ * Narrowing the correctly rounded double is itself correctly rounded
+ * unless the double lands exactly halfway between two floats, where the
+ * second rounding may go the wrong way; only those go back to strtof.
+ */
+arg_error_code_t arg_parse_float(const char *str, float *out) {
+    double number;
+    arg_error_code_t code = arg_parse_double(str, &number);
+    if (code != ARG_OK) {
+        return code;
+    }
+
+    float value = (float)number;
+    if (isinf(value)) {
+        return ARG_ERR_OUT_OF_RANGE;
+    }
+    if ((double)value != number) {
+        float other = nextafterf(value, number > value ? INFINITY : -INFINITY);
+        if (number - value == other - number) {
+            value = convert_slow_float(str);
+        }
+    }
+    *out = value;
+    return ARG_OK;
+}
+
+/**
+ * Helper function to map a size suffix to its multiplier
+ * Returns 0 for an unknown suffix or a multiplier beyond 64 bits
+ */
+static uint64_t size_multiplier(const char *suffix) {
+    static const char prefixes[] = "KMGTPE";
+    if (*suffix == '\0') {
+        return 1;
+    }
+
+    // Case folding below is only meaningful for ASCII letters; a space
+    // would fold to the terminator that strchr matches
+    char letter = (char)(suffix[0] & ~0x20);
+    if (letter < 'A' || letter > 'Z') {
+        return 0;
+    }
+
+    const char *prefix = strchr(prefixes, letter);
+    if (!prefix || letter == 'B') {
+        // Only a lone "B" remains valid without a prefix
+        return (suffix[0] | 0x20) == 'b' && suffix[1] == '\0' ? 1 : 0;
+    }
+
+    unsigned power = (unsigned)(prefix - prefixes) + 1;
+    const char *rest = suffix + 1;
+    uint64_t base;
+    if (*rest == '\0') {
+        base = 1024;
+    } else if ((rest[0] | 0x20) == 'i' && (rest[1] | 0x20) == 'b' && rest[2] == '\0') {
+        base = 1024;
+    } else if ((rest[0] | 0x20) == 'b' && rest[1] == '\0') {
+        base = 1000;
+    } else {
+        return 0;
+    }
+
+    uint64_t multiplier = 1;
+    while (power--) {
+        if (__builtin_mul_overflow(multiplier, base, &multiplier)) {
+            return 0;
+        }
+    }
+    return multiplier;
+}
+
+/**
+ * Helper function to scale whole.fraction by a multiplier, truncating
+ * fraction / scale is the fractional part, with scale a power of ten
+ */
+static bool scale_checked(uint64_t whole, uint64_t fraction, uint64_t scale,
+                          uint64_t multiplier, uint64_t *out) {
+    uint64_t value;
+    if (__builtin_mul_overflow(whole, multiplier, &value)) {
+        return false;
+    }
+    if (fraction != 0) {
+#ifdef __SIZEOF_INT128__
+        // __extension__ keeps -Wpedantic quiet about the GNU type
+        __extension__ typedef unsigned __int128 uint128_t;
+        uint64_t part = (uint64_t)((uint128_t)fraction * multiplier / scale);
+#else
+        uint64_t part = (uint64_t)((long double)fraction * multiplier / scale);
+#endif
+        if (__builtin_add_overflow(value, part, &value)) {
+            return false;
+        }
+    }
+    *out = value;
+    return true;
+}
+
+/**
+ * Helper function to read an optional fraction after the whole digits
+ * Digits beyond 18 only affect precision below the unit's resolution.
+ * Returns the position after the fraction, or NULL if a '.' has no digits
+ */
+static const char *parse_fraction(const char *p, uint64_t *fraction, uint64_t *scale) {
+    *fraction = 0;
+    *scale = 1;
+    if (*p != '.') {
+        return p;
+    }
+    p++;
+    if (!is_digit(*p)) {
+        return NULL;
+    }
+    for (; is_digit(*p); p++) {
+        if (*scale < 1000000000000000000ULL) {
+            *fraction = *fraction * 10 + (uint64_t)(*p - '0');
+            *scale *= 10;
+        }
+    }
+    return p;
+}
+
+/**
+ * Parse a byte size with an optional SI or IEC suffix
+ */
+arg_error_code_t arg_parse_size(const char *str, uint64_t *out) {
+    const char *end = str + strlen(str);
+    uint64_t whole;
+    bool overflow;
+    size_t length = parse_digits(str, end, &whole, &overflow);
+    if (length == 0) {
+        return ARG_ERR_INVALID_NUMBER;
+    }
+
+    uint64_t fraction;
+    uint64_t scale;
+    const char *p = parse_fraction(str + length, &fraction, &scale);
+    if (!p) {
+        return ARG_ERR_INVALID_NUMBER;
+    }
+
+    uint64_t multiplier = size_multiplier(p);
+    if (multiplier == 0 || (scale > 1 && multiplier == 1)) {
+        return ARG_ERR_INVALID_NUMBER;
+    }
+
+    uint64_t value;
+    if (overflow || !scale_checked(whole, fraction, scale, multiplier, &value)) {
+        return ARG_ERR_OUT_OF_RANGE;
+    }
+
+    *out = value;
+    return ARG_OK;
+}
+
+/**
+ * Helper function to match a duration unit at p
+ * Returns the unit length in bytes and sets *nanoseconds, or 0 if unknown
+ */
+static size_t duration_unit(const char *p, uint64_t *nanoseconds) {
+    static const struct {
+        const char *name;
+        uint64_t nanoseconds;
+    } units[] = {
+        // Longer names first so "ms" is not read as "m"
+        {"ns", 1ULL},
+        {"us", 1000ULL},
+        {"\xC2\xB5s", 1000ULL},   // U+00B5 micro sign
+        {"\xCE\xBCs", 1000ULL},   // U+03BC greek small letter mu
+        {"ms", 1000000ULL},
+        {"s", 1000000000ULL},
+        {"m", 60000000000ULL},
+        {"h", 3600000000000ULL},
+    };
+
+    for (size_t i = 0; i < sizeof(units) / sizeof(units[0]); i++) {
+        size_t length = strlen(units[i].name);
+        if (strncmp(p, units[i].name, length) == 0) {
+            *nanoseconds = units[i].nanoseconds;
+            return length;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Parse a duration into nanoseconds
+ */
+arg_error_code_t arg_parse_duration(const char *str, int64_t *out) {
+    const char *p = str;
+    bool negative = false;
+    if (*p == '-' || *p == '+') {
+        negative = *p == '-';
+        p++;
+    }
+
+    if (p[0] == '0' && p[1] == '\0') {
+        *out = 0;
+        return ARG_OK;
+    }
+
+    const char *end = p + strlen(p);
+    uint64_t total = 0;
+    bool over = false;
+    do {
+        uint64_t whole;
+        bool overflow;
+        size_t length = parse_digits(p, end, &whole, &overflow);
+        if (length == 0 && *p != '.') {
+            return ARG_ERR_INVALID_NUMBER;
+        }
+
+        uint64_t fraction;
+        uint64_t scale;
+        p = parse_fraction(p + length, &fraction, &scale);
+        if (!p) {
+            return ARG_ERR_INVALID_NUMBER;
+        }
+
+        uint64_t unit;
+        size_t unit_length = duration_unit(p, &unit);
+        if (unit_length == 0) {
+            return ARG_ERR_INVALID_NUMBER;
+        }
+        p += unit_length;
+
+        // Keep validating the rest after an overflow: malformed beats too large
+        uint64_t component;
+        over |= overflow || !scale_checked(whole, fraction, scale, unit, &component) ||
+                __builtin_add_overflow(total, component, &total);
+    } while (*p != '\0');
+
+    uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+    if (over || total > limit) {
+        return ARG_ERR_OUT_OF_RANGE;
+    }
+    *out = negative ? (int64_t)(0 - total) : (int64_t)total;
+    return ARG_OK;
+}
@@ -0,0 +1,70 @@
+#ifndef PROGRAM_ARGUMENTS_NUMERIC_H
+#define PROGRAM_ARGUMENTS_NUMERIC_H
+
+#include "../includes/program_arguments.h"
+#include <stdint.h>
+
+/**
+ * Strict, locale-independent numeric conversion
+ *
+ * The whole string must be a number: no leading or trailing whitespace,
+ * no trailing garbage. Failures are ARG_ERR_INVALID_NUMBER for malformed
+ * input and ARG_ERR_OUT_OF_RANGE when the value does not fit.
+ */
+
+/**
+ * Parse a decimal integer with optional sign into [min, max]
+ */
+arg_error_code_t arg_parse_int64(const char *str, int64_t min, int64_t max,
+                                 int64_t *out);
+
+/**
+ * arg_parse_int64() on the first length bytes of str, which need not be
+ * NUL-terminated
+ */
+arg_error_code_t arg_parse_int64_n(const char *str, size_t length, int64_t min,
+                                   int64_t max, int64_t *out);
+
+/**
+ * Parse a decimal unsigned integer (optional '+') into [0, max]
+ */
+arg_error_code_t arg_parse_uint64(const char *str, uint64_t max, uint64_t *out);
+
+/**
+ * Parse a decimal floating-point number ([+-]digits[.digits][(e|E)[+-]digits])
+ * Results are correctly rounded; values that overflow to infinity are
+ * ARG_ERR_OUT_OF_RANGE.
+ */
+arg_error_code_t arg_parse_double(const char *str, double *out);
+
+/**
+ * Parse a decimal floating-point number into a float, correctly rounded
+ * Values that round to infinity are ARG_ERR_OUT_OF_RANGE, so FLT_MAX
+ * written with fewer digits ("3.4028235e38") is accepted.
+ */
+arg_error_code_t arg_parse_float(const char *str, float *out);
+
+/**
+ * arg_parse_double() on the first length bytes of str
+ * The byte after them must not continue a number (no digit, sign, '.', 'e'
+ * or 'E'), since the slow path hands str to strtod.
+ */
+arg_error_code_t arg_parse_double_n(const char *str, size_t length, double *out);
+
+/**
+ * Parse a byte size: digits[.digits][suffix]
+ * Suffixes are case-insensitive: B; KB, MB, GB, TB, PB, EB are SI (powers
+ * of 1000); KiB ... EiB and the bare K, M, G, T, P, E are IEC (powers of
+ * 1024). A fraction needs a suffix and is truncated to whole bytes.
+ */
+arg_error_code_t arg_parse_size(const char *str, uint64_t *out);
+
+/**
+ * Parse a duration into nanoseconds: [+-](digits[.digits]unit)+
+ * Units are ns, us (or µs), ms, s, m and h; components may be combined
+ * ("1h30m") and a bare "0" is accepted. Fractions below a nanosecond are
+ * truncated.
+ */
+arg_error_code_t arg_parse_duration(const char *str, int64_t *out);
+
+#endif //PROGRAM_ARGUMENTS_NUMERIC_H
@@ -1,47 +1,256 @@
 #include "../includes/program_arguments.h"
+#include "constraint.h"
+#include "internal.h"
+#include "memory.h"
+#include "numeric.h"
+#include "range_list.h"
+#include "response.h"
+#include "split.h"
+#include "tokenize.h"
+#include <assert.h>
+#include <ctype.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
 #define INITIAL_CAPACITY 8
+#define INDEX_EMPTY 0
+
+static_assert(ARG_TYPE_STRING_LIST <= ARG_TRAIT_TYPE, "argument types must fit in ARG_TRAIT_TYPE");
 
 /**
- * Initialize argument parser
+ * FNV-1a hash of an argument name that also measures it, used by the
+ * compiled name slots. The low bits pick the slot and the high half is
+ * kept as a tag.
  */
-arg_parser_t *arg_parser_create(void) {
-    arg_parser_t *parser = (arg_parser_t *)malloc(sizeof(arg_parser_t));
-    if (!parser) {
-        return NULL;
+static uint64_t hash_name_length(const char *name, size_t *length) {
+    uint64_t hash = 14695981039346656037ULL;
+    const char *cursor = name;
+    while (*cursor) {
+        hash ^= (unsigned char)*cursor++;
+        hash *= 1099511628211ULL;
     }
+    *length = (size_t)(cursor - name);
+    return hash;
+}
+
+/**
+ * FNV-1a hash of an argument name, used by the name index
+ */
+static size_t hash_name(const char *name) {
+    size_t length;
+    return (size_t)hash_name_length(name, &length);
+}
+
+/**
+ * Helper function to pack the traits of a definition
+ */
+static uint8_t pack_traits(const arg_def_t *def) {
+    return (uint8_t)((unsigned)def->type |
+                     (def->required ? ARG_TRAIT_REQUIRED : 0) |
+                     (def->validator ? ARG_TRAIT_VALIDATOR : 0));
+}
+
+/**
+ * Helper function to read the traits of a definition
+ * Only compiled and generated specs carry a traits array; a parser's own
+ * spec packs them on the fly
+ */
+static unsigned definition_traits(const arg_spec_t *spec, size_t i) {
+    return spec->traits ? spec->traits[i] : pack_traits(&spec->definitions[i]);
+}
+
+/**
+ * Helper function to allocate a parser with no spec attached
+ */
+static arg_parser_t *create_parser(const arg_parser_options_t *options) {
+    // The parser itself comes from its own memory source; in arena mode
+    // that makes it the first allocation of the first block
+    arg_memory_t memory;
+    arg_memory_init(&memory, options);
 
-    parser->definitions = (arg_def_t *)malloc(INITIAL_CAPACITY * sizeof(arg_def_t));
-    if (!parser->definitions) {
-        free(parser);
+    arg_parser_t *parser = (arg_parser_t *)arg_memory_alloc(&memory, sizeof(arg_parser_t));
+    if (!parser) {
         return NULL;
     }
 
-    parser->definition_count = 0;
-    parser->definition_capacity = INITIAL_CAPACITY;
+    parser->memory = memory;
+    parser->flags = options ? options->flags : 0;
+    memset(&parser->own_spec, 0, sizeof(parser->own_spec));
+    parser->spec = &parser->own_spec;
     parser->results = NULL;
+    parser->result_count = 0;
     parser->positional_args = NULL;
     parser->positional_count = 0;
     parser->positional_capacity = 0;
+    parser->lists = NULL;
+    parser->response_files = NULL;
+    parser->command = NULL;
+    parser->command_capacity = 0;
+    parser->command_argv = NULL;
+    parser->command_argv_capacity = 0;
+
+    return parser;
+}
+
+/**
+ * Helper function to free a parser created by create_parser()
+ */
+static void free_parser(arg_parser_t *parser) {
+    // The allocator lives inside the parser, so free through a copy
+    arg_memory_t memory = parser->memory;
+    arg_memory_free(&memory, parser);
+    arg_memory_release(&memory);
+}
+
+/**
+ * Initialize argument parser
+ */
+arg_parser_t *arg_parser_create(void) {
+    return arg_parser_create_with_options(NULL);
+}
+
+/**
+ * Initialize argument parser with options
+ */
+arg_parser_t *arg_parser_create_with_options(const arg_parser_options_t *options) {
+    arg_parser_t *parser = create_parser(options);
+    if (!parser) {
+        return NULL;
+    }
+
+    size_t capacity = options && options->definition_capacity > 0 ?
+                      options->definition_capacity : INITIAL_CAPACITY;
+    parser->own_spec.definitions = (arg_def_t *)arg_memory_calloc(&parser->memory, capacity,
+                                                                  sizeof(arg_def_t));
+    if (!parser->own_spec.definitions) {
+        free_parser(parser);
+        return NULL;
+    }
+    parser->own_spec.definition_capacity = capacity;
+
+    return parser;
+}
+
+/**
+ * Initialize a per-parse parser over a compiled spec
+ */
+arg_parser_t *arg_parser_create_for_spec(const arg_spec_t *spec,
+                                         const arg_parser_options_t *options) {
+    if (!spec) {
+        return NULL;
+    }
 
+    arg_parser_t *parser = create_parser(options);
+    if (!parser) {
+        return NULL;
+    }
+    parser->spec = spec;
     return parser;
 }
 
+/**
+ * Helper function to get the spec a parser may still add definitions to
+ * Returns NULL for parsers attached to a shared compiled spec
+ */
+static arg_spec_t *mutable_spec(arg_parser_t *parser) {
+    if (!parser || parser->spec != &parser->own_spec) {
+        return NULL;
+    }
+    return &parser->own_spec;
+}
+
 /**
  * Helper function to resize definitions array
  */
-static int resize_definitions(arg_parser_t *parser) {
-    size_t new_capacity = parser->definition_capacity * 2;
-    arg_def_t *new_defs = (arg_def_t *)realloc(parser->definitions,
-                                                new_capacity * sizeof(arg_def_t));
+static int resize_definitions(arg_spec_t *spec, arg_memory_t *memory) {
+    size_t new_capacity = spec->definition_capacity * 2;
+    arg_def_t *new_defs = (arg_def_t *)arg_memory_realloc(memory, spec->definitions,
+                                                           spec->definition_capacity * sizeof(arg_def_t),
+                                                           new_capacity * sizeof(arg_def_t));
     if (!new_defs) {
         return -1;
     }
-    parser->definitions = new_defs;
-    parser->definition_capacity = new_capacity;
+    spec->definitions = new_defs;
+
+    // The constraint table only exists once a constraint was attached
+    if (spec->constraints) {
+        arg_constraint_t *new_constraints = (arg_constraint_t *)arg_memory_realloc(
+            memory, spec->constraints, spec->definition_capacity * sizeof(arg_constraint_t),
+            new_capacity * sizeof(arg_constraint_t));
+        if (!new_constraints) {
+            return -1;
+        }
+        memset(new_constraints + spec->definition_capacity, 0,
+               (new_capacity - spec->definition_capacity) * sizeof(arg_constraint_t));
+        spec->constraints = new_constraints;
+    }
+    spec->definition_capacity = new_capacity;
+    return 0;
+}
+
+/**
+ * Helper function to insert a name into the open-addressing index.
+ * Slots hold definition index + 1 so that zero marks an empty slot.
+ */
+static void index_insert(size_t *index, size_t capacity, const char *name,
+                         size_t slot_value) {
+    size_t mask = capacity - 1;
+    size_t pos = hash_name(name) & mask;
+    while (index[pos] != INDEX_EMPTY) {
+        pos = (pos + 1) & mask;
+    }
+    index[pos] = slot_value;
+}
+
+/**
+ * Helper function to (re)build the name index with the given capacity
+ */
+static int rebuild_index(arg_spec_t *spec, arg_memory_t *memory, size_t capacity) {
+    size_t *index = (size_t *)arg_memory_calloc(memory, capacity, sizeof(size_t));
+    if (!index) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < spec->definition_count; i++) {
+        const arg_def_t *def = &spec->definitions[i];
+        if (def->long_name) {
+            index_insert(index, capacity, def->long_name, i + 1);
+        }
+        if (def->short_name) {
+            index_insert(index, capacity, def->short_name, i + 1);
+        }
+    }
+
+    arg_memory_free(memory, spec->index);
+    spec->index = index;
+    spec->index_capacity = capacity;
+    return 0;
+}
+
+/**
+ * Helper function to add the names of the newest definition to the index.
+ * The table is kept at most half full so probe sequences stay short.
+ */
+static int index_definition(arg_spec_t *spec, arg_memory_t *memory) {
+    size_t names = spec->definition_count * 2;
+    if (names * 2 > spec->index_capacity) {
+        // The first table already fits every reserved definition
+        size_t capacity = spec->index_capacity == 0 ?
+                          INITIAL_CAPACITY * 4 : spec->index_capacity;
+        while (capacity < spec->definition_capacity * 4 || names * 2 > capacity) {
+            capacity *= 2;
+        }
+        return rebuild_index(spec, memory, capacity);
+    }
+
+    size_t i = spec->definition_count - 1;
+    const arg_def_t *def = &spec->definitions[i];
+    index_insert(spec->index, spec->index_capacity, def->long_name, i + 1);
+    if (def->short_name) {
+        index_insert(spec->index, spec->index_capacity, def->short_name, i + 1);
+    }
     return 0;
 }
 
@@ -51,17 +260,18 @@ static int resize_definitions(arg_parser_t *parser) {
 static int add_argument(arg_parser_t *parser, const char *short_name,
                        const char *long_name, const char *description,
                        arg_type_t type, bool required, arg_value_t default_value) {
-    if (!parser || !long_name) {
+    arg_spec_t *spec = mutable_spec(parser);
+    if (!spec || !long_name) {
         return -1;
     }
 
-    if (parser->definition_count >= parser->definition_capacity) {
-        if (resize_definitions(parser) != 0) {
+    if (spec->definition_count >= spec->definition_capacity) {
+        if (resize_definitions(spec, &parser->memory) != 0) {
             return -1;
         }
     }
 
-    arg_def_t *def = &parser->definitions[parser->definition_count];
+    arg_def_t *def = &spec->definitions[spec->definition_count];
     def->short_name = short_name;
     def->long_name = long_name;
     def->description = description;
@@ -69,8 +279,13 @@ static int add_argument(arg_parser_t *parser, const char *short_name,
     def->required = required;
     def->default_value = default_value;
     def->validator = NULL;
+    def->delimiter = '\0';
 
-    parser->definition_count++;
+    spec->definition_count++;
+    if (index_definition(spec, &parser->memory) != 0) {
+        spec->definition_count--;
+        return -1;
+    }
     return 0;
 }
 
@@ -92,10 +307,25 @@ int arg_parser_add_flag(arg_parser_t *parser, const char *short_name,
 int arg_parser_add_string(arg_parser_t *parser, const char *short_name,
                           const char *long_name, const char *description,
                           bool required, const char *default_value) {
+    if (!mutable_spec(parser)) {
+        return -1;
+    }
+
     arg_value_t value;
-    value.string = default_value ? strdup(default_value) : NULL;
-    return add_argument(parser, short_name, long_name, description,
-                       ARG_TYPE_STRING, required, value);
+    value.string = NULL;
+    if (default_value) {
+        value.string = arg_memory_strdup(&parser->memory, default_value);
+        if (!value.string) {
+            return -1;
+        }
+    }
+
+    if (add_argument(parser, short_name, long_name, description,
+                     ARG_TYPE_STRING, required, value) != 0) {
+        arg_memory_free(&parser->memory, value.string);
+        return -1;
+    }
+    return 0;
 }
 
 /**
@@ -123,286 +353,1763 @@ int arg_parser_add_float(arg_parser_t *parser, const char *short_name,
 }
 
 /**
- * Set validator for an argument
+ * Add a 64-bit integer argument
+ */
+int arg_parser_add_int64(arg_parser_t *parser, const char *short_name,
+                         const char *long_name, const char *description,
+                         bool required, int64_t default_value) {
+    arg_value_t value;
+    value.integer64 = default_value;
+    return add_argument(parser, short_name, long_name, description,
+                       ARG_TYPE_INT64, required, value);
+}
+
+/**
+ * Add a 64-bit unsigned integer argument
+ */
+int arg_parser_add_uint64(arg_parser_t *parser, const char *short_name,
+                          const char *long_name, const char *description,
+                          bool required, uint64_t default_value) {
+    arg_value_t value;
+    value.uinteger64 = default_value;
+    return add_argument(parser, short_name, long_name, description,
+                       ARG_TYPE_UINT64, required, value);
+}
+
+/**
+ * Add a double argument
+ */
+int arg_parser_add_double(arg_parser_t *parser, const char *short_name,
+                          const char *long_name, const char *description,
+                          bool required, double default_value) {
+    arg_value_t value;
+    value.floating64 = default_value;
+    return add_argument(parser, short_name, long_name, description,
+                       ARG_TYPE_DOUBLE, required, value);
+}
+
+/**
+ * Add a byte size argument
+ */
+int arg_parser_add_size(arg_parser_t *parser, const char *short_name,
+                        const char *long_name, const char *description,
+                        bool required, uint64_t default_value) {
+    arg_value_t value;
+    value.uinteger64 = default_value;
+    return add_argument(parser, short_name, long_name, description,
+                       ARG_TYPE_SIZE, required, value);
+}
+
+/**
+ * Add a duration argument
+ */
+int arg_parser_add_duration(arg_parser_t *parser, const char *short_name,
+                            const char *long_name, const char *description,
+                            bool required, int64_t default_value) {
+    arg_value_t value;
+    value.integer64 = default_value;
+    return add_argument(parser, short_name, long_name, description,
+                       ARG_TYPE_DURATION, required, value);
+}
+
+/**
+ * Add a range list argument
+ */
+int arg_parser_add_range_list(arg_parser_t *parser, const char *short_name,
+                              const char *long_name, const char *description,
+                              bool required, const char *default_value) {
+    if (!mutable_spec(parser)) {
+        return -1;
+    }
+
+    arg_value_t value;
+    value.range_list = NULL;
+    if (default_value) {
+        arg_range_list_t *list;
+        if (arg_range_list_parse(&parser->memory, default_value, &list) != ARG_OK) {
+            return -1;
+        }
+        value.range_list = list;
+    }
+
+    if (add_argument(parser, short_name, long_name, description,
+                     ARG_TYPE_RANGE_LIST, required, value) != 0) {
+        arg_memory_free(&parser->memory, (void *)value.range_list);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Helper function to tell list option types apart
+ */
+static bool is_list_type(arg_type_t type) {
+    return type == ARG_TYPE_INT64_LIST || type == ARG_TYPE_DOUBLE_LIST ||
+           type == ARG_TYPE_STRING_LIST;
+}
+
+/**
+ * Helper function to get the element size of a list option type
+ */
+static size_t list_item_size(arg_type_t type) {
+    switch (type) {
+        case ARG_TYPE_INT64_LIST:
+            return sizeof(int64_t);
+        case ARG_TYPE_DOUBLE_LIST:
+            return sizeof(double);
+        default:
+            return sizeof(arg_string_view_t);
+    }
+}
+
+/**
+ * Helper function to add a list argument
+ */
+static int add_list(arg_parser_t *parser, const char *short_name,
+                    const char *long_name, const char *description,
+                    arg_type_t type, bool required, char delimiter) {
+    // Numeric items must not run into the delimiter (see arg_parse_double_n)
+    if (type != ARG_TYPE_STRING_LIST && delimiter != '\0' &&
+        (isalnum((unsigned char)delimiter) || strchr("+-.", delimiter))) {
+        return -1;
+    }
+
+    arg_value_t value;
+    value.list = NULL;
+    if (add_argument(parser, short_name, long_name, description,
+                     type, required, value) != 0) {
+        return -1;
+    }
+    arg_spec_t *spec = mutable_spec(parser);
+    spec->definitions[spec->definition_count - 1].delimiter = delimiter;
+    return 0;
+}
+
+/**
+ * Add a 64-bit integer list argument
+ */
+int arg_parser_add_int64_list(arg_parser_t *parser, const char *short_name,
+                              const char *long_name, const char *description,
+                              bool required, char delimiter) {
+    return add_list(parser, short_name, long_name, description,
+                    ARG_TYPE_INT64_LIST, required, delimiter);
+}
+
+/**
+ * Add a double list argument
+ */
+int arg_parser_add_double_list(arg_parser_t *parser, const char *short_name,
+                               const char *long_name, const char *description,
+                               bool required, char delimiter) {
+    return add_list(parser, short_name, long_name, description,
+                    ARG_TYPE_DOUBLE_LIST, required, delimiter);
+}
+
+/**
+ * Add a string list argument
+ */
+int arg_parser_add_string_list(arg_parser_t *parser, const char *short_name,
+                               const char *long_name, const char *description,
+                               bool required, char delimiter) {
+    return add_list(parser, short_name, long_name, description,
+                    ARG_TYPE_STRING_LIST, required, delimiter);
+}
+
+/**
+ * Helper function to find argument definition by short or long name
+ * Returns the definition index, which also addresses parser->results,
+ * or -1 if the name is not registered
+ */
+static int find_definition(const arg_spec_t *spec, const char *name) {
+    if (spec->match) {
+        return spec->match(name);
+    }
+    if (spec->slots) {
+        // Tags and lengths filter candidates before the pool is read
+        size_t length;
+        uint64_t hash = hash_name_length(name, &length);
+        uint32_t tag = (uint32_t)(hash >> 32);
+        size_t mask = spec->slot_capacity - 1;
+        size_t pos = (size_t)hash & mask;
+        while (spec->slots[pos].definition != INDEX_EMPTY) {
+            const arg_name_slot_t *slot = &spec->slots[pos];
+            if (slot->hash == tag && slot->length == length &&
+                memcmp(spec->names + slot->offset, name, length) == 0) {
+                return (int)(slot->definition - 1);
+            }
+            pos = (pos + 1) & mask;
+        }
+        return -1;
+    }
+    if (spec->index_capacity == 0) {
+        return -1;
+    }
+
+    size_t mask = spec->index_capacity - 1;
+    size_t pos = hash_name(name) & mask;
+    while (spec->index[pos] != INDEX_EMPTY) {
+        size_t i = spec->index[pos] - 1;
+        const arg_def_t *def = &spec->definitions[i];
+        if (strcmp(def->long_name, name) == 0 ||
+            (def->short_name && strcmp(def->short_name, name) == 0)) {
+            return (int)i;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+
+/**
+ * Helper function to find argument definition by long name only
+ * The index holds short names too; APIs that take a long name reject them
+ */
+static int find_long_definition(const arg_spec_t *spec, const char *long_name) {
+    int index = find_definition(spec, long_name);
+    if (index >= 0 && strcmp(spec->definitions[index].long_name, long_name) != 0) {
+        return -1;
+    }
+    return index;
+}
+
+/**
+ * Helper function to insert a name into a compiled spec's slots
+ */
+static void slot_insert(arg_name_slot_t *slots, size_t capacity, uint64_t hash,
+                        uint32_t offset, uint32_t length, size_t definition) {
+    size_t mask = capacity - 1;
+    size_t pos = (size_t)hash & mask;
+    while (slots[pos].definition != INDEX_EMPTY) {
+        pos = (pos + 1) & mask;
+    }
+    slots[pos].hash = (uint32_t)(hash >> 32);
+    slots[pos].length = length;
+    slots[pos].offset = offset;
+    slots[pos].definition = (uint32_t)definition + 1;
+}
+
+/**
+ * Compile a parser's definitions into a standalone, immutable spec
+ */
+arg_spec_t *arg_spec_compile(const arg_parser_t *parser) {
+    if (!parser) {
+        return NULL;
+    }
+    const arg_spec_t *source = parser->spec;
+
+    // Lay everything out in one block: header, definitions, slots,
+    // constraints, range list defaults, then the byte-sized parts: strings,
+    // traits and names. The slots keep the load factor of the source's
+    // index; specs with a generated matcher have neither and keep using it
+    size_t definitions_size = source->definition_count * sizeof(arg_def_t);
+    size_t slot_capacity = source->slots ? source->slot_capacity : source->index_capacity;
+    size_t slots_size = slot_capacity * sizeof(arg_name_slot_t);
+    size_t constraints_size = source->constraints ?
+                              source->definition_count * sizeof(arg_constraint_t) : 0;
+    size_t lists_size = 0;
+    size_t strings_size = 0;
+    size_t names_size = 0;
+    for (size_t i = 0; i < source->definition_count; i++) {
+        const arg_def_t *def = &source->definitions[i];
+        if (def->type == ARG_TYPE_STRING && def->default_value.string) {
+            strings_size += strlen(def->default_value.string) + 1;
+        }
+        if (def->type == ARG_TYPE_RANGE_LIST && def->default_value.range_list) {
+            lists_size += arg_range_list_size(def->default_value.range_list);
+        }
+        names_size += strlen(def->long_name) + 1;
+        if (def->short_name) {
+            names_size += strlen(def->short_name) + 1;
+        }
+    }
+    if (names_size > UINT32_MAX || source->definition_count >= UINT32_MAX) {
+        return NULL;
+    }
+
+    const arg_allocator_t *allocator = &parser->memory.allocator;
+    unsigned char *block = (unsigned char *)allocator->allocate(
+        sizeof(arg_spec_t) + definitions_size + slots_size + constraints_size + lists_size +
+        strings_size + source->definition_count + names_size,
+        allocator->context);
+    if (!block) {
+        return NULL;
+    }
+
+    unsigned char *cursor = block + sizeof(arg_spec_t);
+    arg_spec_t *spec = (arg_spec_t *)block;
+    spec->definitions = (arg_def_t *)cursor;
+    spec->definition_count = source->definition_count;
+    spec->definition_capacity = source->definition_count;
+    cursor += definitions_size;
+    spec->index = NULL;
+    spec->index_capacity = 0;
+    spec->slots = slot_capacity > 0 ? (arg_name_slot_t *)cursor : NULL;
+    spec->slot_capacity = slot_capacity;
+    cursor += slots_size;
+    spec->constraints = constraints_size > 0 ? (arg_constraint_t *)cursor : NULL;
+    cursor += constraints_size;
+    unsigned char *lists = cursor;
+    char *strings = (char *)(lists + lists_size);
+    spec->traits = (uint8_t *)(strings + strings_size);
+    spec->names = (char *)(spec->traits + spec->definition_count);
+    size_t names_used = 0;
+    spec->allocator = *allocator;
+    spec->match = source->match;
+
+    if (definitions_size > 0) {
+        memcpy(spec->definitions, source->definitions, definitions_size);
+    }
+    if (slots_size > 0) {
+        memset(spec->slots, 0, slots_size);
+    }
+    if (constraints_size > 0) {
+        memcpy(spec->constraints, source->constraints, constraints_size);
+    }
+
+    // Defaults get their own copies so the spec outlives the parser; lists
+    // go first since their sizes keep the words 8-byte aligned
+    for (size_t i = 0; i < spec->definition_count; i++) {
+        arg_def_t *def = &spec->definitions[i];
+        if (def->type == ARG_TYPE_STRING && def->default_value.string) {
+            size_t size = strlen(def->default_value.string) + 1;
+            memcpy(strings, def->default_value.string, size);
+            def->default_value.string = strings;
+            strings += size;
+        }
+        if (def->type == ARG_TYPE_RANGE_LIST && def->default_value.range_list) {
+            const arg_range_list_t *list = def->default_value.range_list;
+            def->default_value.range_list = arg_range_list_copy_to(lists, list);
+            lists += arg_range_list_size(list);
+        }
+        spec->traits[i] = pack_traits(def);
+
+        // Names move into the pool, so the spec no longer borrows them;
+        // inserting in definition order keeps lookups identical
+        const char *names[2] = {def->long_name, def->short_name};
+        for (int n = 0; n < 2 && names[n]; n++) {
+            size_t length;
+            uint64_t hash = hash_name_length(names[n], &length);
+            char *copy = spec->names + names_used;
+            memcpy(copy, names[n], length + 1);
+            if (n == 0) {
+                def->long_name = copy;
+            } else {
+                def->short_name = copy;
+            }
+            if (spec->slots) {
+                slot_insert(spec->slots, spec->slot_capacity, hash,
+                            (uint32_t)names_used, (uint32_t)length, i);
+            }
+            names_used += length + 1;
+        }
+    }
+
+    return spec;
+}
+
+/**
+ * Free a compiled spec
+ */
+void arg_spec_destroy(arg_spec_t *spec) {
+    if (!spec) {
+        return;
+    }
+    arg_allocator_t allocator = spec->allocator;
+    allocator.deallocate(spec, allocator.context);
+}
+
+/**
+ * Start iterating over a command line
+ */
+void arg_iter_init(arg_iter_t *iter, const arg_spec_t *spec, int argc, char **argv) {
+    if (!iter) {
+        return;
+    }
+    iter->spec = spec;
+    iter->argc = argv ? argc : 0;
+    iter->argv = argv;
+    iter->index = 1;
+}
+
+/**
+ * Read the next option or positional
+ */
+arg_iter_status_t arg_iter_next(arg_iter_t *iter, arg_iter_item_t *item) {
+    if (!iter || !item || !iter->spec || iter->index >= iter->argc) {
+        return ARG_ITER_END;
+    }
+
+    int i = iter->index++;
+    char *arg = iter->argv[i];
+    item->handle = ARG_HANDLE_INVALID;
+    item->definition = NULL;
+    item->value = (arg_string_view_t){arg, strlen(arg)};
+    item->argv_index = i;
+    item->error = ARG_OK;
+
+    if (arg[0] != '-') {
+        return ARG_ITER_POSITIONAL;
+    }
+
+    int index = find_definition(iter->spec, arg);
+    if (index < 0) {
+        item->error = ARG_ERR_UNKNOWN_ARGUMENT;
+        return ARG_ITER_ERROR;
+    }
+    item->handle = index;
+    item->definition = &iter->spec->definitions[index];
+
+    if (item->definition->type == ARG_TYPE_FLAG) {
+        item->value = (arg_string_view_t){NULL, 0};
+        return ARG_ITER_OPTION;
+    }
+    if (iter->index >= iter->argc) {
+        // value still names the option, as in ARG_ERR_MISSING_VALUE errors
+        item->error = ARG_ERR_MISSING_VALUE;
+        return ARG_ITER_ERROR;
+    }
+    char *value = iter->argv[iter->index++];
+    item->value = (arg_string_view_t){value, strlen(value)};
+    return ARG_ITER_OPTION;
+}
+
+/**
+ * Set validator for an argument
+ */
+int arg_parser_set_validator(arg_parser_t *parser, const char *long_name,
+                             arg_validator_fn validator) {
+    if (!parser || !long_name) {
+        return -1;
+    }
+
+    arg_spec_t *spec = mutable_spec(parser);
+    if (!spec) {
+        return -1;
+    }
+
+    int index = find_long_definition(spec, long_name);
+    if (index < 0) {
+        return -1;
+    }
+    spec->definitions[index].validator = validator;
+    return 0;
+}
+
+#define TYPE_BIT(type) (1u << (type))
+
+/**
+ * Helper function to get the constraints of an argument for attaching a
+ * check, allocating the constraint table on first use
+ * Returns NULL if the argument is unknown or its type is not in types
+ */
+static arg_constraint_t *attach_constraint(arg_parser_t *parser, const char *long_name,
+                                           unsigned types) {
+    arg_spec_t *spec = mutable_spec(parser);
+    if (!spec || !long_name) {
+        return NULL;
+    }
+
+    int index = find_long_definition(spec, long_name);
+    if (index < 0 || !(types & TYPE_BIT(spec->definitions[index].type))) {
+        return NULL;
+    }
+
+    if (!spec->constraints) {
+        spec->constraints = (arg_constraint_t *)arg_memory_calloc(
+            &parser->memory, spec->definition_capacity, sizeof(arg_constraint_t));
+        if (!spec->constraints) {
+            return NULL;
+        }
+    }
+    arg_constraint_t *constraint = &spec->constraints[index];
+    constraint->type = (uint8_t)spec->definitions[index].type;
+    return constraint;
+}
+
+/**
+ * Constrain a signed integer argument to [min, max]
+ */
+int arg_parser_set_int_range(arg_parser_t *parser, const char *long_name,
+                             int64_t min, int64_t max) {
+    if (min > max) {
+        return -1;
+    }
+
+    arg_constraint_t *constraint = attach_constraint(
+        parser, long_name,
+        TYPE_BIT(ARG_TYPE_INT) | TYPE_BIT(ARG_TYPE_INT64) | TYPE_BIT(ARG_TYPE_DURATION) |
+        TYPE_BIT(ARG_TYPE_INT64_LIST));
+    if (!constraint) {
+        return -1;
+    }
+    constraint->kinds |= ARG_CONSTRAINT_RANGE;
+    constraint->range.min.integer = min;
+    constraint->range.max.integer = max;
+    return 0;
+}
+
+/**
+ * Constrain an unsigned integer argument to [min, max]
+ */
+int arg_parser_set_uint_range(arg_parser_t *parser, const char *long_name,
+                              uint64_t min, uint64_t max) {
+    if (min > max) {
+        return -1;
+    }
+
+    arg_constraint_t *constraint = attach_constraint(
+        parser, long_name, TYPE_BIT(ARG_TYPE_UINT64) | TYPE_BIT(ARG_TYPE_SIZE));
+    if (!constraint) {
+        return -1;
+    }
+    constraint->kinds |= ARG_CONSTRAINT_RANGE;
+    constraint->range.min.uinteger = min;
+    constraint->range.max.uinteger = max;
+    return 0;
+}
+
+/**
+ * Constrain a floating-point argument to [min, max]
+ */
+int arg_parser_set_float_range(arg_parser_t *parser, const char *long_name,
+                               double min, double max) {
+    // Also rejects NaN bounds
+    if (!(min <= max)) {
+        return -1;
+    }
+
+    arg_constraint_t *constraint = attach_constraint(
+        parser, long_name,
+        TYPE_BIT(ARG_TYPE_FLOAT) | TYPE_BIT(ARG_TYPE_DOUBLE) | TYPE_BIT(ARG_TYPE_DOUBLE_LIST));
+    if (!constraint) {
+        return -1;
+    }
+    // Float values are compared with the bounds as floats would hold them,
+    // so a bound of 0.1 admits a value of 0.1 (which rounds up as a float)
+    if (constraint->type == ARG_TYPE_FLOAT) {
+        min = (float)min;
+        max = (float)max;
+    }
+    constraint->kinds |= ARG_CONSTRAINT_RANGE;
+    constraint->range.min.floating = min;
+    constraint->range.max.floating = max;
+    return 0;
+}
+
+/**
+ * Restrict a string argument to a set of values
+ */
+int arg_parser_set_choices(arg_parser_t *parser, const char *long_name,
+                           const char *const *choices, size_t choice_count) {
+    if (!choices || choice_count == 0 || choice_count > UINT32_MAX) {
+        return -1;
+    }
+    for (size_t i = 0; i < choice_count; i++) {
+        if (!choices[i]) {
+            return -1;
+        }
+    }
+
+    arg_constraint_t *constraint = attach_constraint(
+        parser, long_name, TYPE_BIT(ARG_TYPE_STRING) | TYPE_BIT(ARG_TYPE_STRING_LIST));
+    if (!constraint) {
+        return -1;
+    }
+    constraint->kinds |= ARG_CONSTRAINT_CHOICES;
+    constraint->text.choices = choices;
+    constraint->choice_count = (uint32_t)choice_count;
+    return 0;
+}
+
+/**
+ * Require a string argument to start with a prefix
+ */
+int arg_parser_set_prefix(arg_parser_t *parser, const char *long_name, const char *prefix) {
+    if (!prefix || strlen(prefix) > UINT32_MAX) {
+        return -1;
+    }
+
+    arg_constraint_t *constraint = attach_constraint(
+        parser, long_name, TYPE_BIT(ARG_TYPE_STRING) | TYPE_BIT(ARG_TYPE_STRING_LIST));
+    if (!constraint) {
+        return -1;
+    }
+    constraint->kinds |= ARG_CONSTRAINT_PREFIX;
+    constraint->text.prefix = prefix;
+    constraint->text.prefix_length = (uint32_t)strlen(prefix);
+    return 0;
+}
+
+/**
+ * Require a string argument to end with a suffix
+ */
+int arg_parser_set_suffix(arg_parser_t *parser, const char *long_name, const char *suffix) {
+    if (!suffix || strlen(suffix) > UINT32_MAX) {
+        return -1;
+    }
+
+    arg_constraint_t *constraint = attach_constraint(
+        parser, long_name, TYPE_BIT(ARG_TYPE_STRING) | TYPE_BIT(ARG_TYPE_STRING_LIST));
+    if (!constraint) {
+        return -1;
+    }
+    constraint->kinds |= ARG_CONSTRAINT_SUFFIX;
+    constraint->text.suffix = suffix;
+    constraint->text.suffix_length = (uint32_t)strlen(suffix);
+    return 0;
+}
+
+/**
+ * Validate a result (runs once)
+ */
+bool arg_validate_result(arg_parser_t *parser, arg_result_t *result) {
+    if (!parser || !result) {
+        return false;
+    }
+
+    // If validation already attempted, return cached result
+    if (result->validation_attempted) {
+        return result->is_valid;
+    }
+
+    result->validation_attempted = true;
+
+    // Declarative constraints were checked right after parsing and keep
+    // their own message
+    if (result->constraint_failed) {
+        result->is_valid = false;
+        return false;
+    }
+
+    // If no validator is set, consider it valid
+    if (!result->definition->validator) {
+        result->is_valid = true;
+        return true;
+    }
+
+    // Run the validator; the message only leaves the stack on failure
+    char message[ARG_VALIDATION_ERROR_SIZE];
+    message[0] = '\0';
+    result->is_valid = result->definition->validator(
+        result->value,
+        result->definition->type,
+        message,
+        sizeof(message)
+    );
+    if (!result->is_valid && message[0] != '\0') {
+        message[sizeof(message) - 1] = '\0';
+        // Without memory the failure is still reported, just without detail
+        result->validation_error = arg_memory_strdup(&parser->memory, message);
+    }
+
+    return result->is_valid;
+}
+
+/**
+ * Helper function to add positional argument
+ */
+static int add_positional_arg(arg_parser_t *parser, char *arg) {
+    if (parser->positional_count >= parser->positional_capacity) {
+        size_t new_capacity = parser->positional_capacity == 0 ?
+                              INITIAL_CAPACITY : parser->positional_capacity * 2;
+        char **new_args = (char **)arg_memory_realloc(&parser->memory, parser->positional_args,
+                                                      parser->positional_capacity * sizeof(char *),
+                                                      new_capacity * sizeof(char *));
+        if (!new_args) {
+            return -1;
+        }
+        parser->positional_args = new_args;
+        parser->positional_capacity = new_capacity;
+    }
+
+    if (parser->flags & ARG_PARSER_BORROW_ARGV) {
+        parser->positional_args[parser->positional_count] = arg;
+    } else {
+        parser->positional_args[parser->positional_count] = arg_memory_strdup(&parser->memory, arg);
+        if (!parser->positional_args[parser->positional_count]) {
+            return -1;
+        }
+    }
+    parser->positional_count++;
+    return 0;
+}
+
+/**
+ * Helper function to release values copied during the last parse
+ */
+static void release_parsed_values(arg_parser_t *parser) {
+    // Borrowed values point into argv and are not ours to free
+    bool borrowed = (parser->flags & ARG_PARSER_BORROW_ARGV) != 0;
+
+    for (size_t i = 0; parser->results && i < parser->result_count; i++) {
+        // Validator messages exist only for failures and are always owned
+        arg_memory_free(&parser->memory, parser->results[i].validation_error);
+        parser->results[i].validation_error = NULL;
+
+        if (!parser->results[i].is_set) {
+            continue;
+        }
+        arg_type_t type = (arg_type_t)(definition_traits(parser->spec, i) & ARG_TRAIT_TYPE);
+        if (type == ARG_TYPE_STRING && !borrowed) {
+            arg_memory_free(&parser->memory, parser->results[i].value.string);
+            parser->results[i].is_set = false;
+        } else if (type == ARG_TYPE_RANGE_LIST) {
+            // The decoded list stays in parser->lists for the next parse
+            parser->results[i].is_set = false;
+        } else if (is_list_type(type)) {
+            // Keep the item buffer for the next parse
+            arg_list_t *list = &parser->lists[i];
+            for (size_t c = 0; c < list->copy_count; c++) {
+                arg_memory_free(&parser->memory, list->copies[c]);
+            }
+            list->copy_count = 0;
+            list->count = 0;
+            parser->results[i].is_set = false;
+        }
+    }
+
+    if (borrowed) {
+        return;
+    }
+    for (size_t i = 0; i < parser->positional_count; i++) {
+        arg_memory_free(&parser->memory, parser->positional_args[i]);
+    }
+}
+
+/**
+ * Helper function to restore every result to its default value in place
+ */
+static void restore_defaults(arg_parser_t *parser) {
+    for (size_t i = 0; i < parser->result_count; i++) {
+        parser->results[i].definition = &parser->spec->definitions[i];
+        parser->results[i].value = parser->spec->definitions[i].default_value;
+        parser->results[i].is_set = false;
+        parser->results[i].validation_attempted = false;
+        parser->results[i].is_valid = false;
+        parser->results[i].constraint_failed = false;
+        parser->results[i].validation_error = NULL;
+    }
+}
+
+/**
+ * Helper function to free list storage
+ * Parsed values must have been released first
+ */
+static void free_lists(arg_parser_t *parser) {
+    if (!parser->lists) {
+        return;
+    }
+    for (size_t i = 0; i < parser->result_count; i++) {
+        arg_memory_free(&parser->memory, parser->lists[i].items);
+        arg_memory_free(&parser->memory, parser->lists[i].copies);
+    }
+    arg_memory_free(&parser->memory, parser->lists);
+    parser->lists = NULL;
+}
+
+/**
+ * Helper function to allocate list storage if the spec has list options
+ * Range lists use their entry to keep the decoded bitset buffer, with
+ * capacity counted in words
+ * Returns 0 on success, -1 on allocation failure
+ */
+static int allocate_lists(arg_parser_t *parser) {
+    for (size_t i = 0; i < parser->spec->definition_count; i++) {
+        arg_type_t type = parser->spec->definitions[i].type;
+        if (is_list_type(type) || type == ARG_TYPE_RANGE_LIST) {
+            parser->lists = (arg_list_t *)arg_memory_calloc(
+                &parser->memory, parser->spec->definition_count, sizeof(arg_list_t));
+            return parser->lists ? 0 : -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Helper function to append one occurrence of a list option
+ * The token is split on the definition's delimiter. If any item is
+ * invalid, the items of this occurrence are dropped again.
+ */
+static arg_error_code_t append_list(arg_parser_t *parser, const arg_def_t *def,
+                                    arg_list_t *list, char *token) {
+    char *text = token;
+    bool copied = def->type == ARG_TYPE_STRING_LIST &&
+                  !(parser->flags & ARG_PARSER_BORROW_ARGV);
+    if (copied) {
+        if (list->copy_count >= list->copy_capacity) {
+            size_t capacity = list->copy_capacity == 0 ? INITIAL_CAPACITY
+                                                       : list->copy_capacity * 2;
+            char **copies = (char **)arg_memory_realloc(&parser->memory, list->copies,
+                                                        list->copy_capacity * sizeof(char *),
+                                                        capacity * sizeof(char *));
+            if (!copies) {
+                return ARG_ERR_OUT_OF_MEMORY;
+            }
+            list->copies = copies;
+            list->copy_capacity = capacity;
+        }
+        text = arg_memory_strdup(&parser->memory, token);
+        if (!text) {
+            return ARG_ERR_OUT_OF_MEMORY;
+        }
+        list->copies[list->copy_count++] = text;
+    }
+
+    size_t item_size = list_item_size(def->type);
+    size_t rollback = list->count;
+    size_t text_length = strlen(text);
+    arg_split_t split;
+    arg_split_init(&split, text, text_length, def->delimiter);
+
+    arg_string_view_t item;
+    while (arg_split_next(&split, &item)) {
+        const char *p = item.data;
+        size_t length = item.length;
+
+        if (list->count >= list->capacity) {
+            size_t capacity = list->capacity == 0 ? INITIAL_CAPACITY : list->capacity * 2;
+            void *items = arg_memory_realloc(&parser->memory, list->items,
+                                             list->capacity * item_size,
+                                             capacity * item_size);
+            if (!items) {
+                list->count = rollback;
+                return ARG_ERR_OUT_OF_MEMORY;
+            }
+            list->items = items;
+            list->capacity = capacity;
+        }
+
+        arg_error_code_t code = ARG_OK;
+        switch (def->type) {
+            case ARG_TYPE_INT64_LIST:
+                code = arg_parse_int64_n(p, length, INT64_MIN, INT64_MAX,
+                                         (int64_t *)list->items + list->count);
+                break;
+            case ARG_TYPE_DOUBLE_LIST:
+                code = arg_parse_double_n(p, length, (double *)list->items + list->count);
+                break;
+            default:
+                // Terminate items inside our own copy
+                if (copied && p + length < text + text_length) {
+                    text[(p - text) + length] = '\0';
+                }
+                ((arg_string_view_t *)list->items)[list->count] = item;
+                break;
+        }
+        if (code != ARG_OK) {
+            list->count = rollback;
+            return code;
+        }
+        list->count++;
+    }
+    return ARG_OK;
+}
+
+/**
+ * Get how much of the caller-provided storage the parser has used
+ */
+size_t arg_parser_storage_used(const arg_parser_t *parser) {
+    return parser ? arg_memory_used(&parser->memory) : 0;
+}
+
+/**
+ * Reset parse state for another parse
+ */
+void arg_parser_reset(arg_parser_t *parser) {
+    if (!parser) {
+        return;
+    }
+
+    release_parsed_values(parser);
+    parser->positional_count = 0;
+    restore_defaults(parser);
+
+    // Borrowed tokens from response files go with their mappings
+    arg_response_release(parser);
+}
+
+/**
+ * Helper function to record a parse error
+ * Returns true if parsing should continue
+ */
+static bool report_error(arg_error_sink_t *sink, arg_error_code_t code, int argv_index,
+                         const arg_def_t *definition, const char *argument,
+                         const char *detail) {
+    if (code == ARG_ERR_OUT_OF_MEMORY && sink->fixed_storage) {
+        code = ARG_ERR_CAPACITY;
+    }
+    if (sink->count < sink->capacity) {
+        arg_error_t *error = &sink->errors[sink->count];
+        error->code = code;
+        error->argv_index = argv_index;
+        error->definition = definition;
+        error->argument = argument;
+        error->detail = detail;
+    }
+    if (sink->count == 0) {
+        sink->first = code;
+    }
+    sink->count++;
+    return sink->collect_all && code != ARG_ERR_OUT_OF_MEMORY && code != ARG_ERR_CAPACITY;
+}
+
+/**
+ * Helper function to check the declarative constraints of every given value
+ * One pass over the constraint table right after parsing; failures are
+ * recorded in the results and surface like validator failures
+ */
+static void check_constraints(arg_parser_t *parser) {
+    const arg_constraint_t *constraints = parser->spec->constraints;
+    if (!constraints) {
+        return;
+    }
+
+    for (size_t i = 0; i < parser->result_count; i++) {
+        arg_result_t *result = &parser->results[i];
+        if (constraints[i].kinds == 0 || !result->is_set) {
+            continue;
+        }
+
+        char message[ARG_VALIDATION_ERROR_SIZE];
+        if (!arg_constraint_check(&constraints[i], result->value, message, sizeof(message))) {
+            result->constraint_failed = true;
+            // Without memory the failure is still reported, just without detail
+            result->validation_error = arg_memory_strdup(&parser->memory, message);
+        }
+    }
+}
+
+/**
+ * Parse command line arguments without printing anything
+ */
+arg_error_code_t arg_parse_argv(arg_parser_t *parser, int argc, char **argv,
+                                arg_error_sink_t *sink) {
+    sink->count = 0;
+    sink->first = ARG_OK;
+    sink->fixed_storage = parser->memory.fixed;
+
+    // Start from a clean slate, reusing the buffers of a previous parse
+    arg_parser_reset(parser);
+
+    // (Re)allocate results if definitions were added since the last parse
+    if (parser->result_count != parser->spec->definition_count) {
+        free_lists(parser);
+        arg_memory_free(&parser->memory, parser->results);
+        parser->results = (arg_result_t *)arg_memory_calloc(&parser->memory, parser->spec->definition_count,
+                                                            sizeof(arg_result_t));
+        // Only count the results once list storage exists too, so a later
+        // parse retries instead of using missing lists
+        parser->result_count = 0;
+        if (!parser->results || allocate_lists(parser) != 0) {
+            report_error(sink, ARG_ERR_OUT_OF_MEMORY, -1, NULL, NULL, NULL);
+            return sink->first;
+        }
+        parser->result_count = parser->spec->definition_count;
+        restore_defaults(parser);
+    }
+
+    // Parse arguments, reading through any @file expansion
+    arg_token_stream_t stream;
+    arg_stream_init(&stream, parser, argc, argv);
+    for (;;) {
+        char *arg;
+        // Keep file pages around once an error may point into them
+        stream.release = !(parser->flags & ARG_PARSER_BORROW_ARGV) && sink->count == 0;
+        arg_error_code_t stream_code = arg_stream_next(&stream, &arg);
+        if (stream_code != ARG_OK) {
+            if (!report_error(sink, stream_code, stream.argv_index, NULL, arg, NULL)) {
+                return sink->first;
+            }
+            continue;
+        }
+        if (!arg) {
+            break;
+        }
+        int i = stream.argv_index;
+
+        // Check if it's an option
+        if (arg[0] == '-') {
+            int index = find_definition(parser->spec, arg);
+            if (index < 0) {
+                if (!report_error(sink, ARG_ERR_UNKNOWN_ARGUMENT, i, NULL, arg, NULL)) {
+                    return sink->first;
+                }
+                continue;
+            }
+
+            // Results are laid out in definition order
+            const arg_def_t *def = &parser->spec->definitions[index];
+            arg_result_t *result = &parser->results[index];
+
+            // Parse value based on type
+            if (def->type == ARG_TYPE_FLAG) {
+                result->value.flag = true;
+                result->is_set = true;
+            } else {
+                // Need next argument for value
+                char *value;
+                arg_error_code_t value_code = arg_stream_next(&stream, &value);
+                if (value_code != ARG_OK) {
+                    if (!report_error(sink, value_code, stream.argv_index, def, value, NULL)) {
+                        return sink->first;
+                    }
+                    continue;
+                }
+                if (!value) {
+                    if (!report_error(sink, ARG_ERR_MISSING_VALUE, i, def, arg, NULL)) {
+                        return sink->first;
+                    }
+                    break;
+                }
+                i = stream.argv_index;
+
+                switch (def->type) {
+                    case ARG_TYPE_STRING:
+                        if (parser->flags & ARG_PARSER_BORROW_ARGV) {
+                            result->value.string = value;
+                            break;
+                        }
+                        // Release the copy from an earlier occurrence
+                        if (result->is_set) {
+                            arg_memory_free(&parser->memory, result->value.string);
+                        }
+                        result->value.string = arg_memory_strdup(&parser->memory, value);
+                        if (!result->value.string) {
+                            result->is_set = false;
+                            report_error(sink, ARG_ERR_OUT_OF_MEMORY, i, def, value, NULL);
+                            return sink->first;
+                        }
+                        break;
+                    case ARG_TYPE_INT: {
+                        int64_t number;
+                        arg_error_code_t code = arg_parse_int64(value, INT_MIN, INT_MAX, &number);
+                        if (code != ARG_OK) {
+                            if (!report_error(sink, code, i, def, value, NULL)) {
+                                return sink->first;
+                            }
+                            continue;
+                        }
+                        result->value.integer = (int)number;
+                        break;
+                    }
+                    case ARG_TYPE_FLOAT: {
+                        arg_error_code_t code = arg_parse_float(value, &result->value.floating);
+                        if (code != ARG_OK) {
+                            if (!report_error(sink, code, i, def, value, NULL)) {
+                                return sink->first;
+                            }
+                            continue;
+                        }
+                        break;
+                    }
+                    case ARG_TYPE_INT64: {
+                        arg_error_code_t code = arg_parse_int64(value, INT64_MIN, INT64_MAX,
+                                                                &result->value.integer64);
+                        if (code != ARG_OK) {
+                            if (!report_error(sink, code, i, def, value, NULL)) {
+                                return sink->first;
+                            }
+                            continue;
+                        }
+                        break;
+                    }
+                    case ARG_TYPE_UINT64: {
+                        arg_error_code_t code = arg_parse_uint64(value, UINT64_MAX,
+                                                                 &result->value.uinteger64);
+                        if (code != ARG_OK) {
+                            if (!report_error(sink, code, i, def, value, NULL)) {
+                                return sink->first;
+                            }
+                            continue;
+                        }
+                        break;
+                    }
+                    case ARG_TYPE_DOUBLE: {
+                        arg_error_code_t code = arg_parse_double(value, &result->value.floating64);
+                        if (code != ARG_OK) {
+                            if (!report_error(sink, code, i, def, value, NULL)) {
+                                return sink->first;
+                            }
+                            continue;
+                        }
+                        break;
+                    }
+                    case ARG_TYPE_SIZE: {
+                        arg_error_code_t code = arg_parse_size(value, &result->value.uinteger64);
+                        if (code != ARG_OK) {
+                            if (!report_error(sink, code, i, def, value, NULL)) {
+                                return sink->first;
+                            }
+                            continue;
+                        }
+                        break;
+                    }
+                    case ARG_TYPE_DURATION: {
+                        arg_error_code_t code = arg_parse_duration(value, &result->value.integer64);
+                        if (code != ARG_OK) {
+                            if (!report_error(sink, code, i, def, value, NULL)) {
+                                return sink->first;
+                            }
+                            continue;
+                        }
+                        break;
+                    }
+                    case ARG_TYPE_RANGE_LIST: {
+                        // Decode into the buffer kept from earlier parses; the
+                        // last occurrence wins
+                        arg_list_t *buffer = &parser->lists[index];
+                        arg_range_list_t *list;
+                        arg_error_code_t code = arg_range_list_parse_into(
+                            &parser->memory, value, &buffer->items, &buffer->capacity, &list);
+                        if (code == ARG_ERR_OUT_OF_MEMORY) {
+                            report_error(sink, code, i, def, value, NULL);
+                            return sink->first;
+                        }
+                        if (code != ARG_OK) {
+                            if (!report_error(sink, code, i, def, value, NULL)) {
+                                return sink->first;
+                            }
+                            continue;
+                        }
+                        result->value.range_list = list;
+                        break;
+                    }
+                    case ARG_TYPE_INT64_LIST:
+                    case ARG_TYPE_DOUBLE_LIST:
+                    case ARG_TYPE_STRING_LIST: {
+                        // Every occurrence appends
+                        arg_list_t *list = &parser->lists[index];
+                        arg_error_code_t code = append_list(parser, def, list, value);
+                        if (code == ARG_ERR_OUT_OF_MEMORY) {
+                            report_error(sink, code, i, def, value, NULL);
+                            return sink->first;
+                        }
+                        if (code != ARG_OK) {
+                            if (!report_error(sink, code, i, def, value, NULL)) {
+                                return sink->first;
+                            }
+                            continue;
+                        }
+                        result->value.list = list;
+                        break;
+                    }
+                    default:
+                        break;
+                }
+                result->is_set = true;
+            }
+        } else {
+            // Positional argument
+            if (add_positional_arg(parser, arg) != 0) {
+                report_error(sink, ARG_ERR_OUT_OF_MEMORY, i, NULL, arg, NULL);
+                return sink->first;
+            }
+        }
+    }
+
+    // Check for required arguments; compiled specs answer from their packed traits
+    for (size_t i = 0; i < parser->spec->definition_count; i++) {
+        if ((definition_traits(parser->spec, i) & ARG_TRAIT_REQUIRED) &&
+            !parser->results[i].is_set) {
+            if (!report_error(sink, ARG_ERR_REQUIRED_MISSING, -1,
+                              &parser->spec->definitions[i], NULL, NULL)) {
+                return sink->first;
+            }
+        }
+    }
+
+    check_constraints(parser);
+    return sink->first;
+}
+
+/**
+ * Validate every result, reporting each failure to the sink
+ */
+void arg_validate_all(arg_parser_t *parser, arg_error_sink_t *sink) {
+    for (size_t i = 0; i < parser->result_count; i++) {
+        arg_result_t *result = &parser->results[i];
+        if (!arg_validate_result(parser, result) &&
+            !report_error(sink, ARG_ERR_VALIDATION, -1, result->definition, NULL,
+                          result->validation_error)) {
+            return;
+        }
+    }
+}
+
+/**
+ * Format an error message
+ */
+int arg_error_format(const arg_error_t *error, char *buffer, size_t size) {
+    if (!error) {
+        return -1;
+    }
+
+    const char *name = error->definition ? error->definition->long_name : NULL;
+    const char *argument = error->argument ? error->argument : (name ? name : "");
+
+    switch (error->code) {
+        case ARG_OK:
+            return snprintf(buffer, size, "No error");
+        case ARG_ERR_UNKNOWN_ARGUMENT:
+            return snprintf(buffer, size, "Unknown argument: %s", argument);
+        case ARG_ERR_MISSING_VALUE:
+            return snprintf(buffer, size, "Missing value for argument: %s", argument);
+        case ARG_ERR_REQUIRED_MISSING:
+            return snprintf(buffer, size, "Required argument missing: %s", name ? name : "");
+        case ARG_ERR_VALIDATION:
+            if (error->detail && error->detail[0] != '\0') {
+                return snprintf(buffer, size, "Validation error for %s: %s",
+                                name ? name : "", error->detail);
+            }
+            return snprintf(buffer, size, "Validation error for %s", name ? name : "");
+        case ARG_ERR_OUT_OF_MEMORY:
+            return snprintf(buffer, size, "Out of memory");
+        case ARG_ERR_INVALID_NUMBER:
+            return snprintf(buffer, size, "Invalid number for %s: %s",
+                            name ? name : "", error->argument ? error->argument : "");
+        case ARG_ERR_OUT_OF_RANGE:
+            return snprintf(buffer, size, "Value out of range for %s: %s",
+                            name ? name : "", error->argument ? error->argument : "");
+        case ARG_ERR_RESPONSE_FILE:
+            return snprintf(buffer, size, "Cannot read response file: %s", argument);
+        case ARG_ERR_RESPONSE_NESTING:
+            return snprintf(buffer, size, "Response files nested too deeply: %s", argument);
+        case ARG_ERR_RESPONSE_SYNTAX:
+            return snprintf(buffer, size, "Unterminated quote in response file: %s", argument);
+        case ARG_ERR_UNTERMINATED_QUOTE:
+            return snprintf(buffer, size, "Unterminated quote in command");
+        case ARG_ERR_CAPACITY:
+            return snprintf(buffer, size, "Parser storage exhausted");
+        default:
+            return snprintf(buffer, size, "Unknown error");
+    }
+}
+
+/**
+ * Helper function to print an error to stderr
+ */
+static void print_error(const arg_error_t *error) {
+    char message[512];
+    arg_error_format(error, message, sizeof(message));
+    fprintf(stderr, "%s\n", message);
+}
+
+/**
+ * Parse command line arguments
+ */
+int arg_parser_parse(arg_parser_t *parser, int argc, char **argv) {
+    if (!parser) {
+        return -1;
+    }
+
+    arg_error_t error;
+    arg_error_sink_t sink = {.errors = &error, .capacity = 1,
+                             .first = ARG_OK, .collect_all = false};
+    if (arg_parse_argv(parser, argc, argv, &sink) == ARG_OK) {
+        return 0;
+    }
+
+    if (!(parser->flags & ARG_PARSER_QUIET)) {
+        print_error(&error);
+    }
+    return -1;
+}
+
+/**
+ * Parse command line arguments, collecting every error
+ */
+int arg_parser_parse_with_errors(arg_parser_t *parser, int argc, char **argv,
+                                 arg_error_t *errors, size_t capacity,
+                                 size_t *error_count) {
+    if (!parser || (capacity > 0 && !errors)) {
+        return -1;
+    }
+
+    arg_error_sink_t sink = {.errors = errors, .capacity = capacity,
+                             .first = ARG_OK, .collect_all = true};
+    arg_error_code_t first = arg_parse_argv(parser, argc, argv, &sink);
+    if (first != ARG_ERR_OUT_OF_MEMORY && first != ARG_ERR_CAPACITY && parser->results) {
+        arg_validate_all(parser, &sink);
+    }
+
+    if (error_count) {
+        *error_count = sink.count;
+    }
+    return sink.count == 0 ? 0 : -1;
+}
+
+/**
+ * Helper function to tokenize a command string into the parser's buffers
+ * The text is copied into the reusable command buffer and tokenized there.
+ * *argv starts with an empty program name, followed by the tokens.
+ */
+static arg_error_code_t tokenize_command(arg_parser_t *parser, const char *buffer,
+                                         size_t length, int *argc, char ***argv) {
+    // Values borrowed from the previous command are about to be overwritten
+    arg_parser_reset(parser);
+
+    if (length >= parser->command_capacity) {
+        size_t capacity = length + 1 > INITIAL_CAPACITY * 32 ? length + 1 : INITIAL_CAPACITY * 32;
+        char *command = (char *)arg_memory_realloc(&parser->memory, parser->command,
+                                                   parser->command_capacity, capacity);
+        if (!command) {
+            return parser->memory.fixed ? ARG_ERR_CAPACITY : ARG_ERR_OUT_OF_MEMORY;
+        }
+        parser->command = command;
+        parser->command_capacity = capacity;
+    }
+    if (length > 0) {
+        memcpy(parser->command, buffer, length);
+    }
+    parser->command[length] = '\0';
+
+    char *cursor = parser->command;
+    char *end = parser->command + length;
+    size_t count = 0;
+    for (;;) {
+        // Slot 0 is the program name, and the array stays NULL-terminated
+        if (count + 2 > parser->command_argv_capacity) {
+            size_t capacity = parser->command_argv_capacity == 0 ? INITIAL_CAPACITY
+                                                                 : parser->command_argv_capacity * 2;
+            char **tokens = (char **)arg_memory_realloc(&parser->memory, parser->command_argv,
+                                                        parser->command_argv_capacity * sizeof(char *),
+                                                        capacity * sizeof(char *));
+            if (!tokens) {
+                return parser->memory.fixed ? ARG_ERR_CAPACITY : ARG_ERR_OUT_OF_MEMORY;
+            }
+            parser->command_argv = tokens;
+            parser->command_argv_capacity = capacity;
+        }
+        if (count == 0) {
+            parser->command_argv[count++] = end;
+            continue;
+        }
+
+        while (cursor < end && arg_is_space(*cursor)) {
+            cursor++;
+        }
+        if (cursor == end) {
+            break;
+        }
+        char *token;
+        size_t token_length;
+        if (!arg_tokenize_next(&cursor, end, &token, &token_length)) {
+            return ARG_ERR_UNTERMINATED_QUOTE;
+        }
+        // The copy has a spare byte after end, so there is always room
+        token[token_length] = '\0';
+        if (cursor < end) {
+            cursor++;
+        }
+        if (count >= INT_MAX) {
+            return ARG_ERR_OUT_OF_RANGE;
+        }
+        parser->command_argv[count++] = token;
+    }
+
+    parser->command_argv[count] = NULL;
+    *argc = (int)count;
+    *argv = parser->command_argv;
+    return ARG_OK;
+}
+
+/**
+ * Parse arguments from a single command string
+ */
+int arg_parser_parse_string(arg_parser_t *parser, const char *buffer, size_t length) {
+    if (!parser || (length > 0 && !buffer)) {
+        return -1;
+    }
+
+    int argc;
+    char **argv;
+    arg_error_code_t code = tokenize_command(parser, buffer, length, &argc, &argv);
+    if (code != ARG_OK) {
+        if (!(parser->flags & ARG_PARSER_QUIET)) {
+            arg_error_t error = {code, -1, NULL, NULL, NULL};
+            print_error(&error);
+        }
+        return -1;
+    }
+    return arg_parser_parse(parser, argc, argv);
+}
+
+/**
+ * Parse arguments from a single command string, collecting every error
+ */
+int arg_parser_parse_string_with_errors(arg_parser_t *parser, const char *buffer,
+                                        size_t length, arg_error_t *errors,
+                                        size_t capacity, size_t *error_count) {
+    if (!parser || (length > 0 && !buffer) || (capacity > 0 && !errors)) {
+        return -1;
+    }
+
+    int argc;
+    char **argv;
+    arg_error_code_t code = tokenize_command(parser, buffer, length, &argc, &argv);
+    if (code != ARG_OK) {
+        if (capacity > 0) {
+            errors[0] = (arg_error_t){code, -1, NULL, NULL, NULL};
+        }
+        if (error_count) {
+            *error_count = 1;
+        }
+        return -1;
+    }
+    return arg_parser_parse_with_errors(parser, argc, argv, errors, capacity, error_count);
+}
+
+/**
+ * Get a stable handle for an argument
  */
-int arg_parser_set_validator(arg_parser_t *parser, const char *long_name,
-                             arg_validator_fn validator) {
+arg_handle_t arg_parser_get_handle(const arg_parser_t *parser, const char *long_name) {
     if (!parser || !long_name) {
-        return -1;
+        return ARG_HANDLE_INVALID;
     }
+    return find_long_definition(parser->spec, long_name);
+}
 
-    for (size_t i = 0; i < parser->definition_count; i++) {
-        if (parser->definitions[i].long_name &&
-            strcmp(parser->definitions[i].long_name, long_name) == 0) {
-            parser->definitions[i].validator = validator;
-            return 0;
-        }
+/**
+ * Helper function to resolve a handle to its definition
+ */
+static const arg_def_t *handle_definition(const arg_parser_t *parser, arg_handle_t handle) {
+    if (!parser || handle < 0 || (size_t)handle >= parser->spec->definition_count) {
+        return NULL;
     }
-    return -1;
+    return &parser->spec->definitions[handle];
 }
 
 /**
- * Helper function to find argument definition by name
+ * Get parsed argument result by handle
  */
-static arg_def_t *find_definition(arg_parser_t *parser, const char *name) {
-    for (size_t i = 0; i < parser->definition_count; i++) {
-        if ((parser->definitions[i].long_name && strcmp(parser->definitions[i].long_name, name) == 0) ||
-            (parser->definitions[i].short_name && strcmp(parser->definitions[i].short_name, name) == 0)) {
-            return &parser->definitions[i];
+arg_result_t *arg_parser_get_h(arg_parser_t *parser, arg_handle_t handle) {
+    if (!handle_definition(parser, handle) || !parser->results) {
+        return NULL;
+    }
+
+    arg_result_t *result = &parser->results[handle];
+
+    // Run validation if not already done, reporting a fresh failure
+    bool first_attempt = !result->validation_attempted;
+    if (!arg_validate_result(parser, result)) {
+        if (first_attempt && result->validation_error &&
+            !(parser->flags & ARG_PARSER_QUIET)) {
+            arg_error_t error = {ARG_ERR_VALIDATION, -1, result->definition,
+                                 NULL, result->validation_error};
+            print_error(&error);
         }
+        return NULL;
     }
-    return NULL;
+
+    return result;
 }
 
 /**
- * Helper function to validate a result (runs once)
+ * Get flag value by handle
  */
-static bool validate_result(arg_result_t *result) {
-    if (!result) {
+bool arg_parser_get_flag_h(arg_parser_t *parser, arg_handle_t handle) {
+    arg_result_t *result = arg_parser_get_h(parser, handle);
+    if (!result || result->definition->type != ARG_TYPE_FLAG) {
         return false;
     }
+    return result->value.flag;
+}
 
-    // If validation already attempted, return cached result
-    if (result->validation_attempted) {
-        return result->is_valid;
+/**
+ * Get string value by handle
+ */
+const char *arg_parser_get_string_h(arg_parser_t *parser, arg_handle_t handle) {
+    arg_result_t *result = arg_parser_get_h(parser, handle);
+    if (!result || result->definition->type != ARG_TYPE_STRING) {
+        return NULL;
     }
+    return result->value.string;
+}
 
-    result->validation_attempted = true;
-
-    // If no validator is set, consider it valid
-    if (!result->definition->validator) {
-        result->is_valid = true;
-        return true;
+/**
+ * Get integer value by handle
+ */
+int arg_parser_get_int_h(arg_parser_t *parser, arg_handle_t handle) {
+    arg_result_t *result = arg_parser_get_h(parser, handle);
+    if (!result || result->definition->type != ARG_TYPE_INT) {
+        // Return default value on validation failure
+        const arg_def_t *def = handle_definition(parser, handle);
+        if (def && def->type == ARG_TYPE_INT) {
+            return def->default_value.integer;
+        }
+        return 0;
     }
+    return result->value.integer;
+}
 
-    // Run the validator
-    result->is_valid = result->definition->validator(
-        result->value,
-        result->definition->type,
-        result->validation_error,
-        sizeof(result->validation_error)
-    );
-
-    // If validation failed, print error
-    if (!result->is_valid && result->validation_error[0] != '\0') {
-        fprintf(stderr, "Validation error for %s: %s\n",
-                result->definition->long_name, result->validation_error);
+/**
+ * Get float value by handle
+ */
+float arg_parser_get_float_h(arg_parser_t *parser, arg_handle_t handle) {
+    arg_result_t *result = arg_parser_get_h(parser, handle);
+    if (!result || result->definition->type != ARG_TYPE_FLOAT) {
+        // Return default value on validation failure
+        const arg_def_t *def = handle_definition(parser, handle);
+        if (def && def->type == ARG_TYPE_FLOAT) {
+            return def->default_value.floating;
+        }
+        return 0.0f;
     }
-
-    return result->is_valid;
+    return result->value.floating;
 }
 
 /**
- * Helper function to add positional argument
+ * Get 64-bit integer value by handle
  */
-static int add_positional_arg(arg_parser_t *parser, const char *arg) {
-    if (parser->positional_count >= parser->positional_capacity) {
-        size_t new_capacity = parser->positional_capacity == 0 ?
-                              INITIAL_CAPACITY : parser->positional_capacity * 2;
-        char **new_args = (char **)realloc(parser->positional_args,
-                                           new_capacity * sizeof(char *));
-        if (!new_args) {
-            return -1;
+int64_t arg_parser_get_int64_h(arg_parser_t *parser, arg_handle_t handle) {
+    arg_result_t *result = arg_parser_get_h(parser, handle);
+    if (!result || result->definition->type != ARG_TYPE_INT64) {
+        // Return default value on validation failure
+        const arg_def_t *def = handle_definition(parser, handle);
+        if (def && def->type == ARG_TYPE_INT64) {
+            return def->default_value.integer64;
         }
-        parser->positional_args = new_args;
-        parser->positional_capacity = new_capacity;
+        return 0;
     }
+    return result->value.integer64;
+}
 
-    parser->positional_args[parser->positional_count] = strdup(arg);
-    if (!parser->positional_args[parser->positional_count]) {
-        return -1;
+/**
+ * Get 64-bit unsigned integer value by handle
+ */
+uint64_t arg_parser_get_uint64_h(arg_parser_t *parser, arg_handle_t handle) {
+    arg_result_t *result = arg_parser_get_h(parser, handle);
+    if (!result || result->definition->type != ARG_TYPE_UINT64) {
+        // Return default value on validation failure
+        const arg_def_t *def = handle_definition(parser, handle);
+        if (def && def->type == ARG_TYPE_UINT64) {
+            return def->default_value.uinteger64;
+        }
+        return 0;
     }
-    parser->positional_count++;
-    return 0;
+    return result->value.uinteger64;
 }
 
 /**
- * Parse command line arguments
+ * Get double value by handle
  */
-int arg_parser_parse(arg_parser_t *parser, int argc, char **argv) {
-    if (!parser) {
-        return -1;
+double arg_parser_get_double_h(arg_parser_t *parser, arg_handle_t handle) {
+    arg_result_t *result = arg_parser_get_h(parser, handle);
+    if (!result || result->definition->type != ARG_TYPE_DOUBLE) {
+        // Return default value on validation failure
+        const arg_def_t *def = handle_definition(parser, handle);
+        if (def && def->type == ARG_TYPE_DOUBLE) {
+            return def->default_value.floating64;
+        }
+        return 0.0;
     }
+    return result->value.floating64;
+}
 
-    // Allocate results array
-    parser->results = (arg_result_t *)calloc(parser->definition_count, sizeof(arg_result_t));
-    if (!parser->results) {
-        return -1;
+/**
+ * Get byte size value by handle
+ */
+uint64_t arg_parser_get_size_h(arg_parser_t *parser, arg_handle_t handle) {
+    arg_result_t *result = arg_parser_get_h(parser, handle);
+    if (!result || result->definition->type != ARG_TYPE_SIZE) {
+        // Return default value on validation failure
+        const arg_def_t *def = handle_definition(parser, handle);
+        if (def && def->type == ARG_TYPE_SIZE) {
+            return def->default_value.uinteger64;
+        }
+        return 0;
     }
+    return result->value.uinteger64;
+}
 
-    // Initialize results with default values
-    for (size_t i = 0; i < parser->definition_count; i++) {
-        parser->results[i].definition = &parser->definitions[i];
-        parser->results[i].value = parser->definitions[i].default_value;
-        parser->results[i].is_set = false;
-        parser->results[i].validation_attempted = false;
-        parser->results[i].is_valid = false;
-        parser->results[i].validation_error[0] = '\0';
+/**
+ * Get duration value in nanoseconds by handle
+ */
+int64_t arg_parser_get_duration_h(arg_parser_t *parser, arg_handle_t handle) {
+    arg_result_t *result = arg_parser_get_h(parser, handle);
+    if (!result || result->definition->type != ARG_TYPE_DURATION) {
+        // Return default value on validation failure
+        const arg_def_t *def = handle_definition(parser, handle);
+        if (def && def->type == ARG_TYPE_DURATION) {
+            return def->default_value.integer64;
+        }
+        return 0;
     }
+    return result->value.integer64;
+}
 
-    // Parse arguments
-    for (int i = 1; i < argc; i++) {
-        const char *arg = argv[i];
-
-        // Check if it's an option
-        if (arg[0] == '-') {
-            const arg_def_t *def = find_definition(parser, arg);
-            if (!def) {
-                fprintf(stderr, "Unknown argument: %s\n", arg);
-                return -1;
-            }
+/**
+ * Helper function to get a list option's values by handle
+ */
+static const void *get_list_h(arg_parser_t *parser, arg_handle_t handle, arg_type_t type,
+                              size_t *count) {
+    arg_result_t *result = arg_parser_get_h(parser, handle);
+    const arg_list_t *list = NULL;
+    if (result && result->definition->type == type) {
+        list = result->value.list;
+    }
+    if (count) {
+        *count = list ? list->count : 0;
+    }
+    return list && list->count > 0 ? list->items : NULL;
+}
 
-            // Find corresponding result
-            arg_result_t *result = NULL;
-            for (size_t j = 0; j < parser->definition_count; j++) {
-                if (parser->results[j].definition == def) {
-                    result = &parser->results[j];
-                    break;
-                }
-            }
+/**
+ * Get 64-bit integer list values by handle
+ */
+const int64_t *arg_parser_get_int64_list_h(arg_parser_t *parser, arg_handle_t handle,
+                                           size_t *count) {
+    return (const int64_t *)get_list_h(parser, handle, ARG_TYPE_INT64_LIST, count);
+}
 
-            if (!result) {
-                return -1;
-            }
+/**
+ * Get double list values by handle
+ */
+const double *arg_parser_get_double_list_h(arg_parser_t *parser, arg_handle_t handle,
+                                           size_t *count) {
+    return (const double *)get_list_h(parser, handle, ARG_TYPE_DOUBLE_LIST, count);
+}
 
-            // Parse value based on type
-            if (def->type == ARG_TYPE_FLAG) {
-                result->value.flag = true;
-                result->is_set = true;
-            } else {
-                // Need next argument for value
-                if (i + 1 >= argc) {
-                    fprintf(stderr, "Missing value for argument: %s\n", arg);
-                    return -1;
-                }
-                i++;
-                const char *value = argv[i];
+/**
+ * Get string list values by handle
+ */
+const arg_string_view_t *arg_parser_get_string_list_h(arg_parser_t *parser,
+                                                      arg_handle_t handle, size_t *count) {
+    return (const arg_string_view_t *)get_list_h(parser, handle, ARG_TYPE_STRING_LIST, count);
+}
 
-                switch (def->type) {
-                    case ARG_TYPE_STRING:
-                        result->value.string = strdup(value);
-                        if (!result->value.string) {
-                            return -1;
-                        }
-                        break;
-                    case ARG_TYPE_INT:
-                        result->value.integer = atoi(value);
-                        break;
-                    case ARG_TYPE_FLOAT:
-                        result->value.floating = (float)atof(value);
-                        break;
-                    default:
-                        break;
-                }
-                result->is_set = true;
-            }
-        } else {
-            // Positional argument
-            if (add_positional_arg(parser, arg) != 0) {
-                return -1;
-            }
+/**
+ * Get range list value by handle
+ */
+const arg_range_list_t *arg_parser_get_range_list_h(arg_parser_t *parser, arg_handle_t handle) {
+    arg_result_t *result = arg_parser_get_h(parser, handle);
+    if (!result || result->definition->type != ARG_TYPE_RANGE_LIST) {
+        // Return default value on validation failure
+        const arg_def_t *def = handle_definition(parser, handle);
+        if (def && def->type == ARG_TYPE_RANGE_LIST) {
+            return def->default_value.range_list;
         }
+        return NULL;
     }
+    return result->value.range_list;
+}
 
-    // Check for required arguments
-    for (size_t i = 0; i < parser->definition_count; i++) {
-        if (parser->definitions[i].required && !parser->results[i].is_set) {
-            fprintf(stderr, "Required argument missing: %s\n",
-                    parser->definitions[i].long_name);
-            return -1;
-        }
+/**
+ * Check if an argument was explicitly set by the user, by handle
+ */
+bool arg_parser_is_set_h(arg_parser_t *parser, arg_handle_t handle) {
+    const arg_result_t *result = arg_parser_get_h(parser, handle);
+    if (!result) {
+        return false;
     }
-
-    return 0;
+    return result->is_set;
 }
 
 /**
  * Get parsed argument result by long name
  */
 arg_result_t *arg_parser_get(arg_parser_t *parser, const char *long_name) {
-    if (!parser || !long_name) {
-        return NULL;
-    }
-
-    for (size_t i = 0; i < parser->definition_count; i++) {
-        if (parser->definitions[i].long_name &&
-            strcmp(parser->definitions[i].long_name, long_name) == 0) {
-            arg_result_t *result = &parser->results[i];
-
-            // Run validation if not already done
-            if (!validate_result(result)) {
-                return NULL;
-            }
-
-            return result;
-        }
-    }
-    return NULL;
+    return arg_parser_get_h(parser, arg_parser_get_handle(parser, long_name));
 }
 
 /**
  * Get flag value (convenience function)
  */
 bool arg_parser_get_flag(arg_parser_t *parser, const char *long_name) {
-    arg_result_t *result = arg_parser_get(parser, long_name);
-    if (!result || result->definition->type != ARG_TYPE_FLAG) {
-        return false;
-    }
-    return result->value.flag;
+    return arg_parser_get_flag_h(parser, arg_parser_get_handle(parser, long_name));
 }
 
 /**
  * Get string value (convenience function)
  */
 const char *arg_parser_get_string(arg_parser_t *parser, const char *long_name) {
-    arg_result_t *result = arg_parser_get(parser, long_name);
-    if (!result || result->definition->type != ARG_TYPE_STRING) {
-        return NULL;
-    }
-    return result->value.string;
+    return arg_parser_get_string_h(parser, arg_parser_get_handle(parser, long_name));
 }
 
 /**
  * Get integer value (convenience function)
  */
 int arg_parser_get_int(arg_parser_t *parser, const char *long_name) {
-    arg_result_t *result = arg_parser_get(parser, long_name);
-    if (!result || result->definition->type != ARG_TYPE_INT) {
-        // Return default value on validation failure
-        arg_def_t *def = find_definition(parser, long_name);
-        if (def && def->type == ARG_TYPE_INT) {
-            return def->default_value.integer;
-        }
-        return 0;
-    }
-    return result->value.integer;
+    return arg_parser_get_int_h(parser, arg_parser_get_handle(parser, long_name));
 }
 
 /**
  * Get float value (convenience function)
  */
 float arg_parser_get_float(arg_parser_t *parser, const char *long_name) {
-    arg_result_t *result = arg_parser_get(parser, long_name);
-    if (!result || result->definition->type != ARG_TYPE_FLOAT) {
-        // Return default value on validation failure
-        arg_def_t *def = find_definition(parser, long_name);
-        if (def && def->type == ARG_TYPE_FLOAT) {
-            return def->default_value.floating;
-        }
-        return 0.0f;
-    }
-    return result->value.floating;
+    return arg_parser_get_float_h(parser, arg_parser_get_handle(parser, long_name));
+}
+
+/**
+ * Get 64-bit integer value (convenience function)
+ */
+int64_t arg_parser_get_int64(arg_parser_t *parser, const char *long_name) {
+    return arg_parser_get_int64_h(parser, arg_parser_get_handle(parser, long_name));
+}
+
+/**
+ * Get 64-bit unsigned integer value (convenience function)
+ */
+uint64_t arg_parser_get_uint64(arg_parser_t *parser, const char *long_name) {
+    return arg_parser_get_uint64_h(parser, arg_parser_get_handle(parser, long_name));
+}
+
+/**
+ * Get double value (convenience function)
+ */
+double arg_parser_get_double(arg_parser_t *parser, const char *long_name) {
+    return arg_parser_get_double_h(parser, arg_parser_get_handle(parser, long_name));
+}
+
+/**
+ * Get byte size value (convenience function)
+ */
+uint64_t arg_parser_get_size(arg_parser_t *parser, const char *long_name) {
+    return arg_parser_get_size_h(parser, arg_parser_get_handle(parser, long_name));
+}
+
+/**
+ * Get duration value in nanoseconds (convenience function)
+ */
+int64_t arg_parser_get_duration(arg_parser_t *parser, const char *long_name) {
+    return arg_parser_get_duration_h(parser, arg_parser_get_handle(parser, long_name));
+}
+
+/**
+ * Get 64-bit integer list values (convenience function)
+ */
+const int64_t *arg_parser_get_int64_list(arg_parser_t *parser, const char *long_name,
+                                         size_t *count) {
+    return arg_parser_get_int64_list_h(parser, arg_parser_get_handle(parser, long_name), count);
+}
+
+/**
+ * Get double list values (convenience function)
+ */
+const double *arg_parser_get_double_list(arg_parser_t *parser, const char *long_name,
+                                         size_t *count) {
+    return arg_parser_get_double_list_h(parser, arg_parser_get_handle(parser, long_name), count);
+}
+
+/**
+ * Get string list values (convenience function)
+ */
+const arg_string_view_t *arg_parser_get_string_list(arg_parser_t *parser,
+                                                    const char *long_name, size_t *count) {
+    return arg_parser_get_string_list_h(parser, arg_parser_get_handle(parser, long_name), count);
+}
+
+/**
+ * Get range list value (convenience function)
+ */
+const arg_range_list_t *arg_parser_get_range_list(arg_parser_t *parser, const char *long_name) {
+    return arg_parser_get_range_list_h(parser, arg_parser_get_handle(parser, long_name));
 }
 
 /**
  * Check if an argument was explicitly set by the user
  */
 bool arg_parser_is_set(arg_parser_t *parser, const char *long_name) {
-    const arg_result_t *result = arg_parser_get(parser, long_name);
-    if (!result) {
-        return false;
-    }
-    return result->is_set;
+    return arg_parser_is_set_h(parser, arg_parser_get_handle(parser, long_name));
 }
 
 /**
@@ -427,8 +2134,8 @@ void arg_parser_print_help(arg_parser_t *parser, const char *program_name) {
     printf("Usage: %s [OPTIONS]...\n\n", program_name ? program_name : "program");
     printf("Options:\n");
 
-    for (size_t i = 0; i < parser->definition_count; i++) {
-        const arg_def_t *def = &parser->definitions[i];
+    for (size_t i = 0; i < parser->spec->definition_count; i++) {
+        const arg_def_t *def = &parser->spec->definitions[i];
 
         printf("  ");
         if (def->short_name) {
@@ -453,6 +2160,33 @@ void arg_parser_print_help(arg_parser_t *parser, const char *program_name) {
                 case ARG_TYPE_FLOAT:
                     printf(" <float>");
                     break;
+                case ARG_TYPE_INT64:
+                    printf(" <int64>");
+                    break;
+                case ARG_TYPE_UINT64:
+                    printf(" <uint64>");
+                    break;
+                case ARG_TYPE_DOUBLE:
+                    printf(" <double>");
+                    break;
+                case ARG_TYPE_SIZE:
+                    printf(" <size>");
+                    break;
+                case ARG_TYPE_DURATION:
+                    printf(" <duration>");
+                    break;
+                case ARG_TYPE_RANGE_LIST:
+                    printf(" <list>");
+                    break;
+                case ARG_TYPE_INT64_LIST:
+                    printf(" <int64>...");
+                    break;
+                case ARG_TYPE_DOUBLE_LIST:
+                    printf(" <double>...");
+                    break;
+                case ARG_TYPE_STRING_LIST:
+                    printf(" <string>...");
+                    break;
                 default:
                     break;
             }
@@ -465,6 +2199,15 @@ void arg_parser_print_help(arg_parser_t *parser, const char *program_name) {
             if (def->required) {
                 printf(" (required)");
             }
+            const arg_constraint_t *constraint =
+                parser->spec->constraints ? &parser->spec->constraints[i] : NULL;
+            if (constraint && (constraint->kinds & ARG_CONSTRAINT_CHOICES)) {
+                printf(" (one of:");
+                for (size_t c = 0; c < constraint->choice_count; c++) {
+                    printf("%s %s", c > 0 ? "," : "", constraint->text.choices[c]);
+                }
+                printf(")");
+            }
             printf("\n");
         }
     }
@@ -478,34 +2221,40 @@ void arg_parser_destroy(arg_parser_t *parser) {
         return;
     }
 
-    // Free string default values
-    for (size_t i = 0; i < parser->definition_count; i++) {
-        if (parser->definitions[i].type == ARG_TYPE_STRING &&
-            parser->definitions[i].default_value.string) {
-            free(parser->definitions[i].default_value.string);
-        }
-    }
+    arg_response_release(parser);
 
-    // Free parsed string values
-    if (parser->results) {
-        for (size_t i = 0; i < parser->definition_count; i++) {
-            if (parser->results[i].definition->type == ARG_TYPE_STRING &&
-                parser->results[i].is_set &&
-                parser->results[i].value.string) {
-                free(parser->results[i].value.string);
-            }
-        }
-        free(parser->results);
+    // Arena memory, including the parser itself, goes back in one release
+    if (parser->memory.use_arena) {
+        arg_memory_release(&parser->memory);
+        return;
     }
 
-    // Free positional arguments
-    if (parser->positional_args) {
-        for (size_t i = 0; i < parser->positional_count; i++) {
-            free(parser->positional_args[i]);
+    arg_memory_t *memory = &parser->memory;
+
+    // Free parsed values, then the buffers that held them
+    release_parsed_values(parser);
+    free_lists(parser);
+    arg_memory_free(memory, parser->results);
+    arg_memory_free(memory, parser->positional_args);
+    arg_memory_free(memory, parser->command);
+    arg_memory_free(memory, parser->command_argv);
+
+    // Free the parser's own spec; compiled specs are owned by the caller
+    arg_spec_t *spec = mutable_spec(parser);
+    if (spec) {
+        for (size_t i = 0; i < spec->definition_count; i++) {
+            if (spec->definitions[i].type == ARG_TYPE_STRING &&
+                spec->definitions[i].default_value.string) {
+                arg_memory_free(memory, spec->definitions[i].default_value.string);
+            }
+            if (spec->definitions[i].type == ARG_TYPE_RANGE_LIST) {
+                arg_memory_free(memory, (void *)spec->definitions[i].default_value.range_list);
+            }
         }
-        free(parser->positional_args);
+        arg_memory_free(memory, spec->index);
+        arg_memory_free(memory, spec->constraints);
+        arg_memory_free(memory, spec->definitions);
     }
 
-    free(parser->definitions);
-    free(parser);
+    free_parser(parser);
 }
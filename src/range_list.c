@@ -0,0 +1,219 @@
+#include "range_list.h"
+#include "memory.h"
+#include <stdint.h>
+#include <string.h>
+
+#define WORD_BITS 64
+
+/**
+ * One comma-separated item: first-last:step
+ */
+typedef struct {
+    uint64_t first;
+    uint64_t last;
+    uint64_t step;
+} range_item_t;
+
+/**
+ * Helper function to read a member value
+ * Values at or above the limit saturate there and flag *too_large.
+ * Returns the position after the digits, or NULL if there are none
+ */
+static const char *parse_member(const char *p, uint64_t *value, bool *too_large) {
+    const char *start = p;
+    uint64_t v = 0;
+    for (; (unsigned char)(*p - '0') < 10; p++) {
+        v = v * 10 + (uint64_t)(*p - '0');
+        if (v >= ARG_RANGE_LIST_LIMIT) {
+            v = ARG_RANGE_LIST_LIMIT;
+            *too_large = true;
+        }
+    }
+    *value = v;
+    return p == start ? NULL : p;
+}
+
+/**
+ * Helper function to parse one item
+ * Returns the position after the item, or NULL if it is malformed
+ */
+static const char *parse_item(const char *p, range_item_t *item, bool *too_large) {
+    p = parse_member(p, &item->first, too_large);
+    if (!p) {
+        return NULL;
+    }
+    item->last = item->first;
+    item->step = 1;
+
+    if (*p == '-') {
+        p = parse_member(p + 1, &item->last, too_large);
+        if (!p || item->last < item->first) {
+            return NULL;
+        }
+        if (*p == ':') {
+            p = parse_member(p + 1, &item->step, too_large);
+            if (!p || item->step == 0) {
+                return NULL;
+            }
+        }
+    }
+    return p;
+}
+
+/**
+ * Helper function to set bits first..last (inclusive) a word at a time
+ */
+static void set_run(uint64_t *words, uint64_t first, uint64_t last) {
+    size_t first_word = first / WORD_BITS;
+    size_t last_word = last / WORD_BITS;
+    uint64_t first_mask = ~0ULL << (first % WORD_BITS);
+    uint64_t last_mask = ~0ULL >> (WORD_BITS - 1 - last % WORD_BITS);
+
+    if (first_word == last_word) {
+        words[first_word] |= first_mask & last_mask;
+        return;
+    }
+    words[first_word] |= first_mask;
+    for (size_t w = first_word + 1; w < last_word; w++) {
+        words[w] = ~0ULL;
+    }
+    words[last_word] |= last_mask;
+}
+
+/**
+ * Parse a range list into a bitset, reusing a buffer when it is large enough
+ */
+arg_error_code_t arg_range_list_parse_into(arg_memory_t *memory, const char *str,
+                                           void **buffer, size_t *capacity,
+                                           arg_range_list_t **out) {
+    // First pass validates and finds the largest member to size the bitset
+    uint64_t largest = 0;
+    bool too_large = false;
+    const char *p = str;
+    for (;;) {
+        range_item_t item;
+        p = parse_item(p, &item, &too_large);
+        if (!p) {
+            return ARG_ERR_INVALID_NUMBER;
+        }
+        uint64_t last = item.first + (item.last - item.first) / item.step * item.step;
+        if (last > largest) {
+            largest = last;
+        }
+        if (*p == '\0') {
+            break;
+        }
+        if (*p++ != ',') {
+            return ARG_ERR_INVALID_NUMBER;
+        }
+    }
+    if (too_large) {
+        return ARG_ERR_OUT_OF_RANGE;
+    }
+
+    size_t word_count = (size_t)(largest / WORD_BITS + 1);
+    arg_range_list_t *list = (arg_range_list_t *)*buffer;
+    if (!list || *capacity < word_count) {
+        list = (arg_range_list_t *)arg_memory_alloc(
+            memory, sizeof(arg_range_list_t) + word_count * sizeof(uint64_t));
+        if (!list) {
+            return ARG_ERR_OUT_OF_MEMORY;
+        }
+        arg_memory_free(memory, *buffer);
+        *buffer = list;
+        *capacity = word_count;
+    }
+    list->words = (uint64_t *)(list + 1);
+    list->word_count = word_count;
+    memset(list->words, 0, word_count * sizeof(uint64_t));
+
+    // Second pass sets the bits; the input is known to be well-formed
+    p = str;
+    for (;;) {
+        range_item_t item;
+        p = parse_item(p, &item, &too_large);
+        if (item.step == 1) {
+            set_run(list->words, item.first, item.last);
+        } else {
+            for (uint64_t v = item.first; v <= item.last; v += item.step) {
+                list->words[v / WORD_BITS] |= 1ULL << (v % WORD_BITS);
+            }
+        }
+        if (*p++ == '\0') {
+            break;
+        }
+    }
+
+    // Overlapping items are fine: count the distinct members
+    size_t count = 0;
+    for (size_t w = 0; w < word_count; w++) {
+        count += (size_t)__builtin_popcountll(list->words[w]);
+    }
+    list->count = count;
+
+    *out = list;
+    return ARG_OK;
+}
+
+/**
+ * Parse a range list into a new allocation
+ */
+arg_error_code_t arg_range_list_parse(arg_memory_t *memory, const char *str,
+                                      arg_range_list_t **out) {
+    void *buffer = NULL;
+    size_t capacity = 0;
+    return arg_range_list_parse_into(memory, str, &buffer, &capacity, out);
+}
+
+/**
+ * Size in bytes of a list's allocation
+ */
+size_t arg_range_list_size(const arg_range_list_t *list) {
+    return sizeof(arg_range_list_t) + list->word_count * sizeof(uint64_t);
+}
+
+/**
+ * Copy a list into caller-provided storage
+ */
+arg_range_list_t *arg_range_list_copy_to(void *destination, const arg_range_list_t *list) {
+    arg_range_list_t *copy = (arg_range_list_t *)destination;
+    memcpy(copy, list, arg_range_list_size(list));
+    copy->words = (uint64_t *)(copy + 1);
+    return copy;
+}
+
+/**
+ * Check whether a value is a member of a range list
+ */
+bool arg_range_list_contains(const arg_range_list_t *list, uint64_t value) {
+    if (!list || value / WORD_BITS >= list->word_count) {
+        return false;
+    }
+    return (list->words[value / WORD_BITS] >> (value % WORD_BITS)) & 1;
+}
+
+/**
+ * Find the smallest member of a range list that is >= from
+ */
+int64_t arg_range_list_next(const arg_range_list_t *list, uint64_t from) {
+    if (!list || from / WORD_BITS >= list->word_count) {
+        return -1;
+    }
+
+    size_t w = (size_t)(from / WORD_BITS);
+    uint64_t word = list->words[w] & (~0ULL << (from % WORD_BITS));
+    while (word == 0) {
+        if (++w >= list->word_count) {
+            return -1;
+        }
+        word = list->words[w];
+    }
+    return (int64_t)(w * WORD_BITS + (size_t)__builtin_ctzll(word));
+}
+
+/**
+ * Number of members in a range list
+ */
+size_t arg_range_list_count(const arg_range_list_t *list) {
+    return list ? list->count : 0;
+}
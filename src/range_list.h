@@ -0,0 +1,42 @@
+#ifndef PROGRAM_ARGUMENTS_RANGE_LIST_H
+#define PROGRAM_ARGUMENTS_RANGE_LIST_H
+
+#include "../includes/program_arguments.h"
+
+/**
+ * Range lists ("0-15,32-47:2,64") decoded into a bitset
+ *
+ * A list is one allocation: the arg_range_list_t header followed by its
+ * words, so it can be freed or copied as a unit.
+ */
+
+/**
+ * Parse a range list into a new allocation from memory
+ * Malformed lists are ARG_ERR_INVALID_NUMBER, members at or above
+ * ARG_RANGE_LIST_LIMIT are ARG_ERR_OUT_OF_RANGE.
+ */
+arg_error_code_t arg_range_list_parse(arg_memory_t *memory, const char *str,
+                                      arg_range_list_t **out);
+
+/**
+ * Parse a range list into a reusable buffer
+ * *buffer holds *capacity words from an earlier call, or is NULL. A list
+ * that fits is decoded in place; otherwise a new allocation from memory
+ * replaces the buffer and the old one is freed. The buffer is left alone
+ * when the list is malformed.
+ */
+arg_error_code_t arg_range_list_parse_into(arg_memory_t *memory, const char *str,
+                                           void **buffer, size_t *capacity,
+                                           arg_range_list_t **out);
+
+/**
+ * Size in bytes of a list's allocation
+ */
+size_t arg_range_list_size(const arg_range_list_t *list);
+
+/**
+ * Copy a list into size bytes at destination (see arg_range_list_size())
+ */
+arg_range_list_t *arg_range_list_copy_to(void *destination, const arg_range_list_t *list);
+
+#endif //PROGRAM_ARGUMENTS_RANGE_LIST_H
@@ -0,0 +1,216 @@
+#define _DEFAULT_SOURCE
+#include "response.h"
+#include "memory.h"
+#include "tokenize.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Consumed pages are handed back in steps of this many bytes
+#define RELEASE_STRIDE (1u << 20)
+
+/**
+ * A mapped response file, kept until the parser's next reset
+ */
+struct arg_response_file {
+    struct arg_response_file *next;
+    void *data;
+    size_t size;
+    char *tail;              // Copy of a final token with no room for its NUL
+};
+
+/**
+ * Start streaming argv
+ */
+void arg_stream_init(arg_token_stream_t *stream, arg_parser_t *parser, int argc, char **argv) {
+    stream->parser = parser;
+    stream->argc = argc;
+    stream->argv = argv;
+    stream->next = 1;
+    stream->argv_index = 0;
+    stream->depth = 0;
+    stream->expand = (parser->flags & ARG_PARSER_RESPONSE_FILES) != 0;
+    stream->release = !(parser->flags & ARG_PARSER_BORROW_ARGV);
+}
+
+/**
+ * Helper function to map a response file and push it onto the stream
+ */
+static arg_error_code_t push_file(arg_token_stream_t *stream, const char *name) {
+    const char *path = name + 1;
+    if (stream->depth >= ARG_RESPONSE_MAX_DEPTH) {
+        return ARG_ERR_RESPONSE_NESTING;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return ARG_ERR_RESPONSE_FILE;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        return ARG_ERR_RESPONSE_FILE;
+    }
+
+    // An empty file contributes no tokens and has nothing to map
+    size_t size = (size_t)info.st_size;
+    if (size == 0) {
+        close(fd);
+        return ARG_OK;
+    }
+
+    // Private and writable: tokenizing writes land in our own pages only
+    void *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return ARG_ERR_RESPONSE_FILE;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    arg_parser_t *parser = stream->parser;
+    struct arg_response_file *file = (struct arg_response_file *)arg_memory_alloc(
+        &parser->memory, sizeof(struct arg_response_file));
+    if (!file) {
+        munmap(data, size);
+        return ARG_ERR_OUT_OF_MEMORY;
+    }
+    file->data = data;
+    file->size = size;
+    file->tail = NULL;
+    file->next = parser->response_files;
+    parser->response_files = file;
+
+    arg_response_frame_t *frame = &stream->frames[stream->depth++];
+    frame->cursor = (char *)data;
+    frame->end = (char *)data + size;
+    frame->released = (char *)data;
+    frame->name = name;
+    return ARG_OK;
+}
+
+/**
+ * Helper function to hand back pages that lie entirely before p
+ */
+static void release_pages(arg_response_frame_t *frame, char *p) {
+    if ((size_t)(p - frame->released) < RELEASE_STRIDE) {
+        return;
+    }
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    char *limit = (char *)((uintptr_t)p & ~(uintptr_t)(page - 1));
+    if (limit > frame->released) {
+        madvise(frame->released, (size_t)(limit - frame->released), MADV_DONTNEED);
+        frame->released = limit;
+    }
+}
+
+/**
+ * Helper function to read the next token of the innermost response file
+ * *token is NULL at the end of the file
+ */
+static arg_error_code_t next_file_token(arg_token_stream_t *stream, char **token) {
+    arg_response_frame_t *frame = &stream->frames[stream->depth - 1];
+    char *r = frame->cursor;
+    char *end = frame->end;
+
+    while (r < end && arg_is_space(*r)) {
+        r++;
+    }
+    if (r == end) {
+        frame->cursor = end;
+        *token = NULL;
+        return ARG_OK;
+    }
+
+    if (stream->release) {
+        release_pages(frame, r);
+    }
+
+    char *start;
+    size_t length;
+    if (!arg_tokenize_next(&r, end, &start, &length)) {
+        // The token is not terminated; report the file instead
+        frame->cursor = end;
+        *token = (char *)frame->name;
+        return ARG_ERR_RESPONSE_SYNTAX;
+    }
+
+    if (start + length < end) {
+        start[length] = '\0';
+    } else {
+        // The token fills the file up to its last byte: copy it out
+        struct arg_response_file *file = stream->parser->response_files;
+        while (file && (char *)file->data + file->size != end) {
+            file = file->next;
+        }
+        char *copy = (char *)arg_memory_alloc(&stream->parser->memory, length + 1);
+        if (!copy) {
+            *token = (char *)frame->name;
+            return ARG_ERR_OUT_OF_MEMORY;
+        }
+        memcpy(copy, start, length);
+        copy[length] = '\0';
+        file->tail = copy;
+        start = copy;
+    }
+
+    frame->cursor = r < end ? r + 1 : end;
+    *token = start;
+    return ARG_OK;
+}
+
+/**
+ * Get the next token
+ */
+arg_error_code_t arg_stream_next(arg_token_stream_t *stream, char **token) {
+    for (;;) {
+        char *next;
+        if (stream->depth > 0) {
+            arg_error_code_t code = next_file_token(stream, &next);
+            if (code != ARG_OK) {
+                *token = next;
+                return code;
+            }
+            if (!next) {
+                stream->depth--;
+                continue;
+            }
+        } else {
+            if (stream->next >= stream->argc) {
+                *token = NULL;
+                return ARG_OK;
+            }
+            stream->argv_index = stream->next;
+            next = stream->argv[stream->next++];
+        }
+
+        if (stream->expand && next[0] == '@' && next[1] != '\0') {
+            arg_error_code_t code = push_file(stream, next);
+            if (code != ARG_OK) {
+                *token = next;
+                return code;
+            }
+            continue;
+        }
+
+        *token = next;
+        return ARG_OK;
+    }
+}
+
+/**
+ * Unmap every response file mapped by the parser
+ */
+void arg_response_release(arg_parser_t *parser) {
+    struct arg_response_file *file = parser->response_files;
+    while (file) {
+        struct arg_response_file *next = file->next;
+        munmap(file->data, file->size);
+        arg_memory_free(&parser->memory, file->tail);
+        arg_memory_free(&parser->memory, file);
+        file = next;
+    }
+    parser->response_files = NULL;
+}
@@ -0,0 +1,60 @@
+#ifndef PROGRAM_ARGUMENTS_RESPONSE_H
+#define PROGRAM_ARGUMENTS_RESPONSE_H
+
+#include "../includes/program_arguments.h"
+
+/**
+ * Token stream over argv with @file expansion
+ *
+ * Response files are mapped privately and tokenized in place, one token
+ * per request: quotes are removed by compacting the token and it is
+ * NUL-terminated where its delimiter was, so tokens are plain strings
+ * inside the mapping. Mappings stay until the parser's next reset.
+ */
+
+/**
+ * One response file being read
+ */
+typedef struct {
+    char *cursor;            // Next unread byte
+    char *end;
+    char *released;          // Pages before this were handed back
+    const char *name;        // The @file token that opened it
+} arg_response_frame_t;
+
+/**
+ * Token stream state for one parse
+ */
+typedef struct {
+    arg_parser_t *parser;
+    int argc;
+    char **argv;
+    int next;                // Next argv index to read
+    int argv_index;          // argv index the last token came from
+    arg_response_frame_t frames[ARG_RESPONSE_MAX_DEPTH];
+    int depth;               // Response files currently open
+    bool expand;             // Expand @file tokens
+    bool release;            // Hand consumed pages back (tokens are not borrowed)
+} arg_token_stream_t;
+
+/**
+ * Start streaming argv[1..argc-1]
+ */
+void arg_stream_init(arg_token_stream_t *stream, arg_parser_t *parser, int argc, char **argv);
+
+/**
+ * Get the next token
+ * *token is NULL at the end of the stream. On error, *token is the
+ * offending token (the @file token for errors inside a file) and
+ * stream->argv_index the argv position it stems from; the stream can keep
+ * going after the error.
+ * @return ARG_OK or the error code
+ */
+arg_error_code_t arg_stream_next(arg_token_stream_t *stream, char **token);
+
+/**
+ * Unmap every response file mapped by the parser
+ */
+void arg_response_release(arg_parser_t *parser);
+
+#endif //PROGRAM_ARGUMENTS_RESPONSE_H
@@ -0,0 +1,143 @@
+#include "split.h"
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
+
+#define CHUNK_SIZE 64
+
+typedef uint64_t (*chunk_scanner_fn)(const char *chunk, char delimiter);
+
+/**
+ * Helper function to scan a chunk one byte at a time
+ */
+static uint64_t scan_chunk_scalar(const char *chunk, char delimiter) {
+    uint64_t mask = 0;
+    for (unsigned i = 0; i < CHUNK_SIZE; i++) {
+        mask |= (uint64_t)(chunk[i] == delimiter) << i;
+    }
+    return mask;
+}
+
+#ifdef HAVE_X86_SIMD
+/**
+ * Helper function to scan a chunk as four 16-byte SSE2 compares
+ */
+static uint64_t scan_chunk_sse2(const char *chunk, char delimiter) {
+    __m128i needle = _mm_set1_epi8(delimiter);
+    uint64_t mask = 0;
+    for (unsigned i = 0; i < CHUNK_SIZE; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(chunk + i));
+        uint64_t bits = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, needle));
+        mask |= bits << i;
+    }
+    return mask;
+}
+
+/**
+ * Helper function to scan a chunk as two 32-byte AVX2 compares
+ */
+__attribute__((target("avx2")))
+static uint64_t scan_chunk_avx2(const char *chunk, char delimiter) {
+    __m256i needle = _mm256_set1_epi8(delimiter);
+    __m256i low = _mm256_loadu_si256((const __m256i *)chunk);
+    __m256i high = _mm256_loadu_si256((const __m256i *)(chunk + 32));
+    uint64_t low_bits = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, needle));
+    uint64_t high_bits = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, needle));
+    return low_bits | high_bits << 32;
+}
+#endif
+
+static chunk_scanner_fn scan_chunk = scan_chunk_scalar;
+static const char *scanner_name = "scalar";
+static pthread_once_t scanner_once = PTHREAD_ONCE_INIT;
+
+/**
+ * Helper function to pick the widest scanner the CPU supports
+ */
+static void select_scanner(void) {
+#ifdef HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        scan_chunk = scan_chunk_avx2;
+        scanner_name = "avx2";
+        return;
+    }
+    // SSE2 is part of the x86-64 baseline
+    scan_chunk = scan_chunk_sse2;
+    scanner_name = "sse2";
+#endif
+}
+
+/**
+ * Helper function to compute the delimiter mask of the chunk at split->chunk
+ * The final partial chunk is scanned bytewise so nothing is read past end
+ */
+static uint64_t chunk_mask(const arg_split_t *split) {
+    size_t remaining = (size_t)(split->end - split->chunk);
+    if (remaining >= CHUNK_SIZE) {
+        return scan_chunk(split->chunk, split->delimiter);
+    }
+    uint64_t mask = 0;
+    for (size_t i = 0; i < remaining; i++) {
+        mask |= (uint64_t)(split->chunk[i] == split->delimiter) << i;
+    }
+    return mask;
+}
+
+/**
+ * Start splitting text on a delimiter
+ */
+void arg_split_init(arg_split_t *split, const char *text, size_t length, char delimiter) {
+    pthread_once(&scanner_once, select_scanner);
+    split->chunk = text;
+    split->end = text + length;
+    split->token = text;
+    split->delimiter = delimiter;
+    split->done = false;
+    split->mask = 0;
+    if (delimiter == '\0') {
+        split->chunk = split->end;
+    } else if (length > 0) {
+        split->mask = chunk_mask(split);
+    }
+}
+
+/**
+ * Get the next token
+ */
+bool arg_split_next(arg_split_t *split, arg_string_view_t *token) {
+    if (split->done) {
+        return false;
+    }
+
+    while (split->mask == 0) {
+        if (split->end - split->chunk <= CHUNK_SIZE) {
+            // No delimiters left: the rest is the last token
+            token->data = split->token;
+            token->length = (size_t)(split->end - split->token);
+            split->done = true;
+            return true;
+        }
+        split->chunk += CHUNK_SIZE;
+        split->mask = chunk_mask(split);
+    }
+
+    const char *delimiter = split->chunk + __builtin_ctzll(split->mask);
+    split->mask &= split->mask - 1;
+    token->data = split->token;
+    token->length = (size_t)(delimiter - split->token);
+    split->token = delimiter + 1;
+    return true;
+}
+
+/**
+ * Name of the scanner selected for this CPU
+ */
+const char *arg_split_implementation(void) {
+    pthread_once(&scanner_once, select_scanner);
+    return scanner_name;
+}
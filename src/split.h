@@ -0,0 +1,45 @@
+#ifndef PROGRAM_ARGUMENTS_SPLIT_H
+#define PROGRAM_ARGUMENTS_SPLIT_H
+
+#include "../includes/program_arguments.h"
+#include <stdint.h>
+
+/**
+ * Delimiter splitting without copies
+ *
+ * The text is scanned 64 bytes at a time into a bitmask of delimiter
+ * positions (AVX2 or SSE2 when the CPU has them, scalar otherwise), so
+ * consecutive short tokens come out of one mask without rescanning.
+ */
+
+/**
+ * Split state; tokens are views into the text
+ */
+typedef struct {
+    const char *chunk;       // Start of the 64-byte chunk the mask covers
+    const char *end;
+    const char *token;       // Start of the next token
+    uint64_t mask;           // Delimiter positions in the chunk not yet consumed
+    char delimiter;
+    bool done;
+} arg_split_t;
+
+/**
+ * Start splitting length bytes of text on delimiter
+ * Empty text yields a single empty token, and a '\0' delimiter yields the
+ * whole text as one token without scanning it.
+ */
+void arg_split_init(arg_split_t *split, const char *text, size_t length, char delimiter);
+
+/**
+ * Get the next token
+ * @return false when all tokens have been returned
+ */
+bool arg_split_next(arg_split_t *split, arg_string_view_t *token);
+
+/**
+ * Name of the scanner selected for this CPU ("avx2", "sse2" or "scalar")
+ */
+const char *arg_split_implementation(void);
+
+#endif //PROGRAM_ARGUMENTS_SPLIT_H
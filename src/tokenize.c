@@ -0,0 +1,43 @@
+#include "tokenize.h"
+
+/**
+ * Read the next token, unquoting it in place
+ */
+bool arg_tokenize_next(char **cursor, char *end, char **token, size_t *length) {
+    char *r = *cursor;
+    char *start = r;
+    char *w = r;
+    char quote = '\0';
+
+    while (r < end) {
+        char c = *r;
+        if (quote) {
+            if (c == quote) {
+                quote = '\0';
+                r++;
+                continue;
+            }
+            if (quote == '"' && c == '\\' && r + 1 < end && (r[1] == '"' || r[1] == '\\')) {
+                c = *++r;
+            }
+        } else if (arg_is_space(c)) {
+            break;
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+            r++;
+            continue;
+        } else if (c == '\\' && r + 1 < end) {
+            c = *++r;
+        }
+        if (w != r) {
+            *w = c;
+        }
+        w++;
+        r++;
+    }
+
+    *cursor = r;
+    *token = start;
+    *length = (size_t)(w - start);
+    return quote == '\0';
+}
@@ -0,0 +1,34 @@
+#ifndef PROGRAM_ARGUMENTS_TOKENIZE_H
+#define PROGRAM_ARGUMENTS_TOKENIZE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Shell-like tokenizing in place
+ *
+ * Tokens are separated by whitespace. '...' is literal, "..." allows \"
+ * and \\ escapes, and a backslash outside quotes escapes the next
+ * character. Quotes are removed by compacting the token towards its start;
+ * bytes are only written once the token has shrunk, so plain tokens leave
+ * the text untouched.
+ */
+
+/**
+ * Read the next token between *cursor and end
+ * On return *cursor is just past the token: at the whitespace byte that
+ * ended it, or at end. The unquoted token is *token[0..*length), which the
+ * caller terminates; there is room for a NUL at *token + *length unless
+ * that is end.
+ * @return false if the text ends inside quotes
+ */
+bool arg_tokenize_next(char **cursor, char *end, char **token, size_t *length);
+
+/**
+ * Check for a token separator
+ */
+static inline bool arg_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+#endif //PROGRAM_ARGUMENTS_TOKENIZE_H
@@ -15,6 +15,8 @@ NC='\033[0m' # No Color
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 BUILD_DIR="${SCRIPT_DIR}/cmake-build-debug"
 EXAMPLE_BIN="${BUILD_DIR}/example"
+GENERATED_BIN="${BUILD_DIR}/example-generated"
+FEATURES_BIN="${BUILD_DIR}/example-features"
 
 TOTAL_TESTS=0
 PASSED_TESTS=0
@@ -73,6 +75,28 @@ run_test_with_output() {
     fi
 }
 
+# Build a string list value of the given length with delimiters at the
+# given byte offsets. Item k is filled with the k-th letter, so a misplaced
+# split changes the output. Sets LIST_VALUE and LIST_PATTERN, the expected
+# "values -T" output.
+build_boundary_list() {
+    local length=$1
+    shift
+    local letters=abcdefghijklmnopqrstuvwxyz
+    local start=0 index=0 offset item
+    LIST_VALUE=""
+    LIST_PATTERN="tags="
+    for offset in "$@" "$length"; do
+        item=$(printf '%*s' $((offset - start)) '' | tr ' ' "${letters:$((index % 26)):1}")
+        LIST_VALUE+="$item"
+        [ "$offset" -lt "$length" ] && LIST_VALUE+=","
+        LIST_PATTERN+="\\[$item\\]"
+        start=$((offset + 1))
+        index=$((index + 1))
+    done
+    LIST_PATTERN+=" ($index)\$"
+}
+
 # Print header
 echo "========================================"
 echo "Program Arguments Library - Test Suite"
@@ -97,9 +121,194 @@ run_test_with_output "Missing required" "$EXAMPLE_BIN" "Required argument missin
 
 echo ""
 echo "=== Validation Tests ==="
-run_test_with_output "Invalid count" "$EXAMPLE_BIN -i input.txt -n 150" "Count must be between"
-run_test_with_output "Invalid threshold" "$EXAMPLE_BIN -i input.txt -t 2.0" "Threshold must be between"
+run_test_with_output "Invalid count" "$EXAMPLE_BIN -i input.txt -n 150" "Validation error for --count: must be between 1 and 100, got 150"
+run_test_with_output "Invalid threshold" "$EXAMPLE_BIN -i input.txt -t 2.0" "Validation error for --threshold: must be between 0 and 1, got 2"
 run_test_with_output "Invalid file ext" "$EXAMPLE_BIN -i input.txt -o file.pdf" "must have .txt extension"
+run_test_with_output "Invalid number" "$EXAMPLE_BIN -i input.txt -n 12abc" "Invalid number for --count"
+run_test_with_output "Number out of range" "$EXAMPLE_BIN -i input.txt -n 99999999999" "Value out of range"
+run_test_with_output "Float max accepted" "$EXAMPLE_BIN -i input.txt -t 3.4028235e38" "Validation error for --threshold"
+run_test_with_output "Float out of range" "$EXAMPLE_BIN -i input.txt -t 3.5e38" "Value out of range for --threshold"
+run_test_with_output "Valid choice" "$EXAMPLE_BIN -i input.txt -m fast" "Mode: fast"
+run_test_with_output "Invalid choice" "$EXAMPLE_BIN -i input.txt -m slow" "must be one of fast, balanced, thorough"
+
+echo ""
+echo "=== Generated Spec Tests ==="
+run_test_with_output "Generated defaults" "$GENERATED_BIN -i in.png" "to 640x480"
+run_test_with_output "Generated options" "$GENERATED_BIN --input in.png -W 100 --max-bytes 1K" "to 100x480.*1024 bytes"
+run_test_with_output "Generated validator" "$GENERATED_BIN -i in.png -H 0" "Dimension must be between"
+run_test_with_output "Generated unknown" "$GENERATED_BIN -i in.png --width-x 1" "Unknown argument: --width-x"
+
+echo ""
+echo "=== Numeric Tests ==="
+run_test_with_output "Int64 minimum" "$FEATURES_BIN values -i -9223372036854775808" "offset=-9223372036854775808"
+run_test_with_output "Int64 maximum" "$FEATURES_BIN values -i 9223372036854775807" "offset=9223372036854775807"
+run_test_with_output "Int64 overflow" "$FEATURES_BIN values -i 9223372036854775808" "Value out of range for --offset: 9223372036854775808"
+run_test_with_output "Int64 underflow" "$FEATURES_BIN values -i -9223372036854775809" "Value out of range for --offset"
+run_test_with_output "Int64 trailing text" "$FEATURES_BIN values -i 12abc" "Invalid number for --offset: 12abc"
+run_test_with_output "Uint64 maximum" "$FEATURES_BIN values -u 18446744073709551615" "budget=18446744073709551615"
+run_test_with_output "Uint64 overflow" "$FEATURES_BIN values -u 18446744073709551616" "Value out of range for --budget: 18446744073709551616"
+run_test_with_output "Uint64 negative" "$FEATURES_BIN values -u -1" "Invalid number for --budget: -1"
+run_test_with_output "Double value" "$FEATURES_BIN values -r 0.25" "rate=0.25"
+run_test_with_output "Double overflow" "$FEATURES_BIN values -r 1e400" "Value out of range for --rate: 1e400"
+run_test_with_output "Double hex" "$FEATURES_BIN values -r 0x10" "Invalid number for --rate: 0x10"
+run_test_with_output "Double not a number" "$FEATURES_BIN values -r nan" "Invalid number for --rate: nan"
+
+echo ""
+echo "=== Size Tests ==="
+run_test_with_output "Size IEC suffix" "$FEATURES_BIN values -s 1.5MiB" "size=1572864"
+run_test_with_output "Size SI suffix" "$FEATURES_BIN values -s 2kb" "size=2000"
+run_test_with_output "Size bare prefix" "$FEATURES_BIN values -s 1K" "size=1024"
+run_test_with_output "Size bytes" "$FEATURES_BIN values -s 18446744073709551615" "size=18446744073709551615"
+run_test_with_output "Size space before suffix" "$FEATURES_BIN values -s '1 b'" "Invalid number for --size"
+run_test_with_output "Size symbol suffix" "$FEATURES_BIN values -s 1@" "Invalid number for --size"
+run_test_with_output "Size unknown suffix" "$FEATURES_BIN values -s 1KiX" "Invalid number for --size"
+run_test_with_output "Size fraction without suffix" "$FEATURES_BIN values -s 1.5" "Invalid number for --size"
+run_test_with_output "Size overflow" "$FEATURES_BIN values -s 16EiB" "Value out of range for --size"
+run_test_with_output "Size SI overflow" "$FEATURES_BIN values -s 19EB" "Value out of range for --size"
+
+echo ""
+echo "=== Duration Tests ==="
+run_test_with_output "Duration combined units" "$FEATURES_BIN values -d 1h30m" "duration=5400000000000ns"
+run_test_with_output "Duration fraction" "$FEATURES_BIN values -d 1.5s" "duration=1500000000ns"
+run_test_with_output "Duration negative" "$FEATURES_BIN values -d -250ms" "duration=-250000000ns"
+run_test_with_output "Duration micro sign" "$FEATURES_BIN values -d 10µs" "duration=10000ns"
+run_test_with_output "Duration bare zero" "$FEATURES_BIN values -d 0" "duration=0ns"
+run_test_with_output "Duration minimum" "$FEATURES_BIN values -d -9223372036854775808ns" "duration=-9223372036854775808ns"
+run_test_with_output "Duration missing unit" "$FEATURES_BIN values -d 1" "Invalid number for --duration"
+run_test_with_output "Duration unknown unit" "$FEATURES_BIN values -d 1x" "Invalid number for --duration"
+run_test_with_output "Duration space before unit" "$FEATURES_BIN values -d '1 s'" "Invalid number for --duration"
+run_test_with_output "Duration overflow" "$FEATURES_BIN values -d 2562048h" "Value out of range for --duration"
+run_test_with_output "Duration nanosecond overflow" "$FEATURES_BIN values -d 9223372036854775808ns" "Value out of range for --duration"
+
+echo ""
+echo "=== Range List Tests ==="
+run_test_with_output "Range list range" "$FEATURES_BIN values -c 0-3" "cpus=0 1 2 3 (4)"
+run_test_with_output "Range list overlap" "$FEATURES_BIN values -c 0-3,2-5" "cpus=0 1 2 3 4 5 (6)"
+run_test_with_output "Range list step" "$FEATURES_BIN values -c 0-15:4,3" "cpus=0 3 4 8 12 (5)"
+run_test_with_output "Range list single range" "$FEATURES_BIN values -c 5-5" "cpus=5 (1)"
+run_test_with_output "Range list reverse" "$FEATURES_BIN values -c 5-3" "Invalid number for --cpus"
+run_test_with_output "Range list zero step" "$FEATURES_BIN values -c 0-7:0" "Invalid number for --cpus"
+run_test_with_output "Range list empty item" "$FEATURES_BIN values -c 1,,2" "Invalid number for --cpus"
+run_test_with_output "Range list limit" "$FEATURES_BIN values -c 1048576" "Value out of range for --cpus"
+
+echo ""
+echo "=== Arena Tests ==="
+run_test_with_output "Arena reparse" "$FEATURES_BIN arena -o result.txt -n 7 a b c" "pass 2: output length=10 count=7 positionals=3"
+run_test_with_output "Arena block spill" "$FEATURES_BIN arena -o \$(printf 'x%.0s' {1..5000})" "pass 2: output length=5000"
+run_test_with_output "Arena validation" "$FEATURES_BIN arena -n 500" "Count must be between 1 and 100, got 500"
+run_test_with_output "Arena unknown" "$FEATURES_BIN arena --bogus" "Unknown argument: --bogus"
+run_test_with_output "Allocator callbacks balanced" "$FEATURES_BIN allocator -o result.txt -n 7 a b c" "callbacks balanced"
+run_test_with_output "Allocator no malloc fallback" "$FEATURES_BIN allocator -o result.txt -n 7 a b c" "malloc fallback: \(none\|unchecked\)"
+run_test_with_output "Allocator arena balanced" "$FEATURES_BIN allocator --arena -o \$(printf 'x%.0s' {1..1000}) a" "callbacks balanced"
+run_test_with_output "Allocator arena no malloc fallback" "$FEATURES_BIN allocator --arena -n 500 a" "malloc fallback: \(none\|unchecked\)"
+run_test_with_output "Allocator rejected parse balanced" "$FEATURES_BIN allocator --bogus" "callbacks balanced"
+run_test_with_output "Storage reparse" "$FEATURES_BIN storage 4096 -o out -n 7 -T a,b,c -c 0-3 x y" "pass 3: count=7 cpus=4 positionals=2"
+run_test_with_output "Storage stops growing" "$FEATURES_BIN storage 4096 -o out -n 7 -T a,b,c -c 0-3 x y" "storage growth after first parse: none"
+run_test_with_output "Storage range list regrowth" "$FEATURES_BIN storage 4096 -c 0-3 -c 0-1000" "storage growth after first parse: none"
+run_test_with_output "Storage no malloc fallback" "$FEATURES_BIN storage 4096 -o out -n 7 -T a,b,c -c 0-3 x y" "malloc fallback: \(none\|unchecked\)"
+STORAGE_USED=$($FEATURES_BIN storage 4096 -o out -n 7 -T a,b,c -c 0-3 x y | sed -n 's/^pass 1: .*used=//p')
+run_test_with_output "Storage high-water size fits" "$FEATURES_BIN storage $STORAGE_USED -o out -n 7 -T a,b,c -c 0-3 x y" "pass 3: count=7"
+run_test_with_output "Storage add failure" "$FEATURES_BIN storage 700 -o out" "added=0/4"
+run_test_with_output "Storage parse capacity" "$FEATURES_BIN storage 1000 -o out -n 7 -T a,b,c -c 0-3 x y" "pass 1: capacity error: Parser storage exhausted"
+run_test_with_output "Storage capacity reparse" "$FEATURES_BIN storage 1000 -o out -n 7 -T a,b,c -c 0-3 x y" "pass 3: capacity error: Parser storage exhausted"
+
+echo ""
+echo "=== List Tests ==="
+run_test_with_output "Integer list occurrences" "$FEATURES_BIN values -I 1,2,3 -I 4" "ids=1 2 3 4 (4)"
+run_test_with_output "Double list separator" "$FEATURES_BIN values -w 0.5:1e3 -w 2" "weights=0.5 1000 2 (3)"
+run_test_with_output "String list empty items" "$FEATURES_BIN values -T a,,b -T ,c" "tags=\[a\]\[\]\[b\]\[\]\[c\] (5)"
+run_test_with_output "String list empty value" "$FEATURES_BIN values -T ''" "tags=\[\] (1)"
+run_test_with_output "Integer list empty item" "$FEATURES_BIN values -I 1,,2" "Invalid number for --ids: 1,,2"
+run_test_with_output "Integer list trailing separator" "$FEATURES_BIN values -I 1,2," "Invalid number for --ids"
+run_test_with_output "Integer list bad item" "$FEATURES_BIN values -I 1,x" "Invalid number for --ids"
+run_test_with_output "Integer list item range" "$FEATURES_BIN values -I 1,99999999999999999999" "Value out of range for --ids"
+run_test_with_output "Double list empty item" "$FEATURES_BIN values -w 1::2" "Invalid number for --weights"
+build_boundary_list 600 15 16 31 32 47 48 63 64 100 127 128 191 192 255 256 383 384 447 448 511
+run_test_with_output "String list lane boundaries" "$FEATURES_BIN values -T $LIST_VALUE" "$LIST_PATTERN"
+build_boundary_list 512 63 127 255 511
+run_test_with_output "String list chunk-aligned end" "$FEATURES_BIN values -T $LIST_VALUE" "$LIST_PATTERN"
+build_boundary_list 320
+run_test_with_output "String list without delimiters" "$FEATURES_BIN values -T $LIST_VALUE" "$LIST_PATTERN"
+
+echo ""
+echo "=== Response File Tests ==="
+RESPONSE_DIR="$(mktemp -d)"
+printf -- '-n 7 @%s/inner.args "two words" last\n' "$RESPONSE_DIR" > "$RESPONSE_DIR/outer.args"
+printf -- "-o 'from inner.txt' a\\\\ b\n" > "$RESPONSE_DIR/inner.args"
+printf -- '@%s/self.args\n' "$RESPONSE_DIR" > "$RESPONSE_DIR/self.args"
+printf -- '-o "never closed\n' > "$RESPONSE_DIR/open.args"
+NESTED_OUTPUT="output=\[from inner.txt\] count=7 positionals=\[a b\]\[two words\]\[last\]\[tail\]"
+run_test_with_output "Response nested (copy)" "$FEATURES_BIN response @$RESPONSE_DIR/outer.args tail" "$NESTED_OUTPUT"
+run_test_with_output "Response nested (borrow)" "$FEATURES_BIN response --borrow @$RESPONSE_DIR/outer.args tail" "$NESTED_OUTPUT"
+run_test_with_output "Response self-recursive (copy)" "$FEATURES_BIN response @$RESPONSE_DIR/self.args" "Response files nested too deeply"
+run_test_with_output "Response self-recursive (borrow)" "$FEATURES_BIN response --borrow @$RESPONSE_DIR/self.args" "Response files nested too deeply"
+run_test_with_output "Response unterminated quote" "$FEATURES_BIN response @$RESPONSE_DIR/open.args" "Unterminated quote in response file"
+run_test_with_output "Response missing file" "$FEATURES_BIN response @$RESPONSE_DIR/missing.args" "Cannot read response file"
+rm -rf "$RESPONSE_DIR"
+
+echo ""
+echo "=== Command String Tests ==="
+COMMAND_TEXT='-n 7 a\ b "c \"d\" \\e" '"'"'f\g'"'"' h""i'
+COMMAND_OUTPUT='count=7 positionals=\[a b\]\[c "d" \\e\]\[f\\g\]\[hi\]'
+run_test_with_output "Command quoting (copy)" "$FEATURES_BIN command \"\$COMMAND_TEXT\"" "$COMMAND_OUTPUT"
+run_test_with_output "Command quoting (borrow)" "$FEATURES_BIN command --borrow \"\$COMMAND_TEXT\"" "$COMMAND_OUTPUT"
+run_test_with_output "Command trailing backslash" "$FEATURES_BIN command 'end\\'" 'positionals=\[end\\\]'
+run_test_with_output "Command blank" "$FEATURES_BIN command '   '" "count=10 positionals=$"
+run_test_with_output "Command unterminated double quote" "$FEATURES_BIN command '-o \"open'" "Unterminated quote in command"
+run_test_with_output "Command unterminated single quote" "$FEATURES_BIN command --borrow \"-o 'open\"" "Unterminated quote in command"
+run_test_with_output "Command unknown" "$FEATURES_BIN command '-n 7 --bogus'" "Unknown argument: --bogus"
+
+echo ""
+echo "=== Iterator Tests ==="
+run_test_with_output "Iterator flag" "$FEATURES_BIN iter -v a" "\[1\] option --verbose=$"
+run_test_with_output "Iterator raw value" "$FEATURES_BIN iter -n 12abc" "\[1\] option --count=12abc"
+run_test_with_output "Iterator positional" "$FEATURES_BIN iter -n 7 input.txt" "\[3\] positional input.txt"
+run_test_with_output "Iterator unknown option" "$FEATURES_BIN iter --bogus -v" "\[1\] error: Unknown argument: --bogus"
+run_test_with_output "Iterator continues after error" "$FEATURES_BIN iter --bogus -v" "\[2\] option --verbose"
+run_test_with_output "Iterator missing value" "$FEATURES_BIN iter -v -o" "\[2\] error: Missing value for argument: -o"
+
+echo ""
+echo "=== Shared Spec Tests ==="
+run_test_with_output "Shared spec first parser" "$FEATURES_BIN shared -o a.txt -n 5 -- -n 7" "parser 0: output=a.txt count=5"
+run_test_with_output "Shared spec second parser" "$FEATURES_BIN shared -o a.txt -n 5 -- -n 7" "parser 1: output=output.txt count=7"
+run_test_with_output "Shared spec validator" "$FEATURES_BIN shared -n 5 -- -n 500" "Count must be between 1 and 100, got 500"
+run_test_with_output "Shared spec unknown" "$FEATURES_BIN shared -n 5 -- --bogus" "parser 1: rejected"
+run_test_with_output "Shared spec isolation" "$FEATURES_BIN shared -n 5 -- --bogus" "parser 0: output=output.txt count=5"
+
+echo ""
+echo "=== Constraint Tests ==="
+run_test_with_output "Float range exact bound" "$FEATURES_BIN values -f 0.1" "fraction=0.1$"
+run_test_with_output "Float range lower bound" "$FEATURES_BIN values -f 0" "fraction=0$"
+run_test_with_output "Float range just above" "$FEATURES_BIN values -f 0.1000001" "must be between 0 and 0.1, got 0.1000001"
+run_test_with_output "Float range below" "$FEATURES_BIN values -f -1e-45" "must be between 0 and 0.1, got -1.4013e-45"
+
+echo ""
+echo "=== Lookup Tests ==="
+run_test_with_output "Lookup long name" "$FEATURES_BIN lookup --dry-run" "get=1/1 parse=1/1"
+run_test_with_output "Lookup long name only" "$FEATURES_BIN lookup --force" "get=2/2 parse=2/2"
+run_test_with_output "Lookup short name" "$FEATURES_BIN lookup -n" "get=-1/-1 parse=1/1"
+run_test_with_output "Lookup unknown" "$FEATURES_BIN lookup --bogus" "get=-1/-1 parse=-1/-1"
+# --cnldfbibmp and --noeoxggjas have the same FNV-1a tag and low hash byte
+run_test_with_output "Lookup tag collision" "$FEATURES_BIN names 0 --cnldfbibmp --noeoxggjas" "shared slot=yes mismatches=0"
+run_test_with_output "Lookup many names" "$FEATURES_BIN names 1000 --cnldfbibmp --noeoxggjas" "names=1002 shared slot=yes mismatches=0"
+
+echo ""
+echo "=== Error Collection Tests ==="
+run_test_with_output "Collect no errors" "$FEATURES_BIN errors -i input.txt -n 5" "errors: 0"
+run_test_with_output "Collect validation error" "$FEATURES_BIN errors -i input.txt -n 500" "Validation error for --count: Count must be between 1 and 100, got 500"
+run_test_with_output "Collect every error" "$FEATURES_BIN errors -n 500 --bogus --more" "errors: 4"
+run_test_with_output "Collect beyond capacity" "$FEATURES_BIN errors -n 500 --bogus --more" "Unknown argument: --more"
+run_test_with_output "Collect missing value" "$FEATURES_BIN errors -n" "Missing value for argument: -n"
+run_test_with_output "Collect required" "$FEATURES_BIN errors -n 5" "Required argument missing: --input"
+
+echo ""
+echo "=== Batch Tests ==="
+run_test_with_output "Batch values" "$FEATURES_BIN batch -n 5 -- -n 7" "record 1: count=7"
+run_test_with_output "Batch validator detail" "$FEATURES_BIN batch -n 500 -- -n 600 -- -n 5" "record 0: error: Validation error for --count: Count must be between 1 and 100, got 500"
+run_test_with_output "Batch unknown" "$FEATURES_BIN batch -n 5 -- --bogus" "record 1: error: Unknown argument: --bogus"
+run_test_with_output "Batch threads" "$FEATURES_BIN batch-threads 1000 4" "records=1000 rejected=100 mismatches=0"
+run_test_with_output "Batch threads uneven" "$FEATURES_BIN batch-threads 201 3" "records=201 rejected=20 mismatches=0"
+run_test_with_output "Batch threads auto" "$FEATURES_BIN batch-threads 130 0" "records=130 rejected=13 mismatches=0"
 
 echo ""
 echo "========================================"
@@ -0,0 +1,778 @@
+#include "program_arguments.h"
+#include "numeric.h"
+#include "tokenize.h"
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// arg-gen: compile a declarative argument spec into C source.
+//
+// Each non-empty line of the spec declares one argument:
+//
+//     <type> --long [-s] [required] [default=V] [delimiter=C] [validator=F] ["description"]
+//
+// Tokens follow response-file quoting, '#' starts a comment line. The
+// output is a static arg_spec_t with its definitions in read-only data and
+// a generated matcher that switches on name length, then on the bytes
+// that tell the remaining candidates apart, and compares at most one
+// candidate string.
+//
+// Range lists and list options take no default, and declarative
+// constraints (ranges, choices, prefix, suffix) have no spec syntax;
+// check those in a validator instead.
+
+#define MAX_NAME_LENGTH 256
+
+typedef struct {
+    arg_type_t type;
+    char *long_name;
+    char *short_name;
+    char *description;
+    char *default_text;
+    char *validator;
+    bool required;
+    char delimiter;
+    arg_value_t default_value;
+    int line;
+} gen_def_t;
+
+typedef struct {
+    const char *name;
+    size_t length;
+    size_t definition;
+} gen_name_t;
+
+typedef struct {
+    const char *input;
+    gen_def_t *defs;
+    size_t count;
+    size_t capacity;
+} gen_spec_t;
+
+static const struct {
+    const char *name;
+    arg_type_t type;
+    const char *constant;
+} types[] = {
+    {"flag", ARG_TYPE_FLAG, "ARG_TYPE_FLAG"},
+    {"string", ARG_TYPE_STRING, "ARG_TYPE_STRING"},
+    {"int", ARG_TYPE_INT, "ARG_TYPE_INT"},
+    {"float", ARG_TYPE_FLOAT, "ARG_TYPE_FLOAT"},
+    {"int64", ARG_TYPE_INT64, "ARG_TYPE_INT64"},
+    {"uint64", ARG_TYPE_UINT64, "ARG_TYPE_UINT64"},
+    {"double", ARG_TYPE_DOUBLE, "ARG_TYPE_DOUBLE"},
+    {"size", ARG_TYPE_SIZE, "ARG_TYPE_SIZE"},
+    {"duration", ARG_TYPE_DURATION, "ARG_TYPE_DURATION"},
+    {"range-list", ARG_TYPE_RANGE_LIST, "ARG_TYPE_RANGE_LIST"},
+    {"int64-list", ARG_TYPE_INT64_LIST, "ARG_TYPE_INT64_LIST"},
+    {"double-list", ARG_TYPE_DOUBLE_LIST, "ARG_TYPE_DOUBLE_LIST"},
+    {"string-list", ARG_TYPE_STRING_LIST, "ARG_TYPE_STRING_LIST"},
+};
+
+#define TYPE_COUNT (sizeof(types) / sizeof(types[0]))
+
+/**
+ * Report an error at a spec line
+ * Always returns -1 so callers can return it directly
+ */
+static int spec_error(const gen_spec_t *spec, int line, const char *message, const char *token) {
+    fprintf(stderr, "%s:%d: %s", spec->input, line, message);
+    if (token) {
+        fprintf(stderr, ": %s", token);
+    }
+    fputc('\n', stderr);
+    return -1;
+}
+
+/**
+ * Helper function to check if a list type accepts a delimiter
+ */
+static bool is_list_type(arg_type_t type) {
+    return type == ARG_TYPE_INT64_LIST || type == ARG_TYPE_DOUBLE_LIST ||
+           type == ARG_TYPE_STRING_LIST;
+}
+
+/**
+ * Helper function to check if a token is a valid C identifier
+ */
+static bool is_identifier(const char *text) {
+    if (!isalpha((unsigned char)*text) && *text != '_') {
+        return false;
+    }
+    for (; *text; text++) {
+        if (!isalnum((unsigned char)*text) && *text != '_') {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Convert a default value with the same rules the parser applies at runtime
+ */
+static int parse_default(const gen_spec_t *spec, gen_def_t *def) {
+    const char *text = def->default_text;
+    arg_error_code_t code = ARG_OK;
+
+    switch (def->type) {
+        case ARG_TYPE_FLAG:
+            if (strcmp(text, "true") == 0 || strcmp(text, "false") == 0) {
+                def->default_value.flag = text[0] == 't';
+            } else {
+                code = ARG_ERR_VALIDATION;
+            }
+            break;
+        case ARG_TYPE_STRING:
+            def->default_value.string = def->default_text;
+            break;
+        case ARG_TYPE_INT: {
+            int64_t number;
+            code = arg_parse_int64(text, INT_MIN, INT_MAX, &number);
+            def->default_value.integer = (int)number;
+            break;
+        }
+        case ARG_TYPE_FLOAT:
+            code = arg_parse_float(text, &def->default_value.floating);
+            break;
+        case ARG_TYPE_INT64:
+        case ARG_TYPE_DURATION:
+            code = def->type == ARG_TYPE_INT64
+                   ? arg_parse_int64(text, INT64_MIN, INT64_MAX, &def->default_value.integer64)
+                   : arg_parse_duration(text, &def->default_value.integer64);
+            break;
+        case ARG_TYPE_UINT64:
+            code = arg_parse_uint64(text, UINT64_MAX, &def->default_value.uinteger64);
+            break;
+        case ARG_TYPE_SIZE:
+            code = arg_parse_size(text, &def->default_value.uinteger64);
+            break;
+        case ARG_TYPE_DOUBLE:
+            code = arg_parse_double(text, &def->default_value.floating64);
+            if (code == ARG_OK && !isfinite(def->default_value.floating64)) {
+                code = ARG_ERR_OUT_OF_RANGE;
+            }
+            break;
+        default:
+            return spec_error(spec, def->line, "type takes no default", text);
+    }
+
+    if (code == ARG_ERR_OUT_OF_RANGE) {
+        return spec_error(spec, def->line, "default out of range", text);
+    }
+    if (code != ARG_OK) {
+        return spec_error(spec, def->line, "invalid default", text);
+    }
+    return 0;
+}
+
+/**
+ * Parse one spec line into a definition
+ * Returns 1 if the line declared an argument, 0 if it was blank, -1 on error
+ */
+static int parse_line(gen_spec_t *spec, char *line, char *end, int number, gen_def_t *def) {
+    memset(def, 0, sizeof(*def));
+    def->line = number;
+    bool have_type = false;
+    char *cursor = line;
+
+    for (;;) {
+        while (cursor < end && arg_is_space(*cursor)) {
+            cursor++;
+        }
+        if (cursor == end || (!have_type && *cursor == '#')) {
+            break;
+        }
+        char *token;
+        size_t length;
+        if (!arg_tokenize_next(&cursor, end, &token, &length)) {
+            return spec_error(spec, number, "unterminated quote", NULL);
+        }
+        // Tokens only shrink while unquoting, so there is room for the NUL
+        bool at_end = cursor == end;
+        token[length] = '\0';
+        if (!at_end) {
+            cursor++;
+        }
+
+        if (!have_type) {
+            size_t t = 0;
+            while (t < TYPE_COUNT && strcmp(types[t].name, token) != 0) {
+                t++;
+            }
+            if (t == TYPE_COUNT) {
+                return spec_error(spec, number, "unknown type", token);
+            }
+            def->type = types[t].type;
+            have_type = true;
+        } else if (strncmp(token, "--", 2) == 0) {
+            if (def->long_name || length < 3 || length > MAX_NAME_LENGTH) {
+                return spec_error(spec, number, "unexpected long name", token);
+            }
+            def->long_name = token;
+        } else if (token[0] == '-') {
+            if (def->short_name || length < 2 || length > MAX_NAME_LENGTH) {
+                return spec_error(spec, number, "unexpected short name", token);
+            }
+            def->short_name = token;
+        } else if (strcmp(token, "required") == 0) {
+            def->required = true;
+        } else if (strncmp(token, "default=", 8) == 0) {
+            def->default_text = token + 8;
+        } else if (strncmp(token, "delimiter=", 10) == 0) {
+            if (length != 11) {
+                return spec_error(spec, number, "delimiter must be one character", token);
+            }
+            def->delimiter = token[10];
+        } else if (strncmp(token, "validator=", 10) == 0) {
+            if (!is_identifier(token + 10)) {
+                return spec_error(spec, number, "validator must be a C identifier", token);
+            }
+            def->validator = token + 10;
+        } else if (!def->description) {
+            def->description = token;
+        } else {
+            return spec_error(spec, number, "unexpected token", token);
+        }
+
+        if (at_end) {
+            break;
+        }
+    }
+
+    if (!have_type) {
+        return 0;
+    }
+    if (!def->long_name) {
+        return spec_error(spec, number, "missing long name", NULL);
+    }
+    if (def->delimiter && !is_list_type(def->type)) {
+        return spec_error(spec, number, "only list types take a delimiter", def->long_name);
+    }
+    if (def->default_text && parse_default(spec, def) != 0) {
+        return -1;
+    }
+    return 1;
+}
+
+/**
+ * Read the whole spec file
+ */
+static int parse_spec(gen_spec_t *spec, char *text, size_t length) {
+    char *line = text;
+    char *end = text + length;
+    int number = 1;
+
+    while (line < end) {
+        char *eol = memchr(line, '\n', (size_t)(end - line));
+        if (!eol) {
+            eol = end;
+        }
+
+        if (spec->count == spec->capacity) {
+            size_t capacity = spec->capacity ? spec->capacity * 2 : 16;
+            gen_def_t *defs = realloc(spec->defs, capacity * sizeof(gen_def_t));
+            if (!defs) {
+                fprintf(stderr, "arg-gen: out of memory\n");
+                return -1;
+            }
+            spec->defs = defs;
+            spec->capacity = capacity;
+        }
+        int rc = parse_line(spec, line, eol, number, &spec->defs[spec->count]);
+        if (rc < 0) {
+            return -1;
+        }
+        spec->count += (size_t)rc;
+
+        line = eol + 1;
+        number++;
+    }
+    return 0;
+}
+
+/**
+ * Build the enum constant for a definition: PREFIX_LONG_NAME
+ */
+static void constant_name(char *out, size_t size, const char *prefix, const char *long_name) {
+    size_t n = 0;
+    for (const char *p = prefix; *p && n + 1 < size; p++) {
+        out[n++] = (char)toupper((unsigned char)*p);
+    }
+    if (n + 1 < size) {
+        out[n++] = '_';
+    }
+    for (const char *p = long_name + 2; *p && n + 1 < size; p++) {
+        out[n++] = isalnum((unsigned char)*p) ? (char)toupper((unsigned char)*p) : '_';
+    }
+    out[n] = '\0';
+}
+
+/**
+ * Check names and enum constants for collisions
+ */
+static int check_unique(const gen_spec_t *spec, const char *prefix) {
+    char a[MAX_NAME_LENGTH * 2];
+    char b[MAX_NAME_LENGTH * 2];
+    for (size_t i = 0; i < spec->count; i++) {
+        const gen_def_t *x = &spec->defs[i];
+        constant_name(a, sizeof(a), prefix, x->long_name);
+        for (size_t j = 0; j < i; j++) {
+            const gen_def_t *y = &spec->defs[j];
+            const char *names[2][2] = {{x->long_name, x->short_name},
+                                       {y->long_name, y->short_name}};
+            for (int p = 0; p < 2; p++) {
+                for (int q = 0; q < 2; q++) {
+                    if (names[0][p] && names[1][q] && strcmp(names[0][p], names[1][q]) == 0) {
+                        return spec_error(spec, x->line, "duplicate name", names[0][p]);
+                    }
+                }
+            }
+            constant_name(b, sizeof(b), prefix, y->long_name);
+            if (strcmp(a, b) == 0) {
+                return spec_error(spec, x->line, "handle constant collides with",
+                                  y->long_name);
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * Write a C string literal
+ */
+static void emit_string(FILE *out, const char *text) {
+    fputc('"', out);
+    for (const unsigned char *p = (const unsigned char *)text; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            fprintf(out, "\\%c", *p);
+        } else if (*p == '?' && p[1] == '?') {
+            fputs("\\?", out);  // No trigraphs
+        } else if (isprint(*p)) {
+            fputc(*p, out);
+        } else {
+            fprintf(out, "\\%03o", *p);
+        }
+    }
+    fputc('"', out);
+}
+
+/**
+ * Write a C character constant
+ */
+static void emit_char(FILE *out, char c) {
+    unsigned char u = (unsigned char)c;
+    if (c == '\0') {
+        fputs("'\\0'", out);
+    } else if (c == '\'' || c == '\\') {
+        fprintf(out, "'\\%c'", c);
+    } else if (isprint(u)) {
+        fprintf(out, "'%c'", c);
+    } else {
+        fprintf(out, "'\\%03o'", u);
+    }
+}
+
+/**
+ * Write the shortest decimal that reads back as the same float or double
+ */
+static void emit_real(FILE *out, double value, bool single) {
+    char text[64];
+    for (int precision = 1; precision <= 17; precision++) {
+        snprintf(text, sizeof(text), "%.*g", precision, value);
+        double back = strtod(text, NULL);
+        if (single ? (float)back == (float)value : back == value) {
+            break;
+        }
+    }
+    fputs(text, out);
+}
+
+static void emit_default(FILE *out, const gen_def_t *def) {
+    if (!def->default_text) {
+        fputs("{0}", out);
+        return;
+    }
+    const arg_value_t *v = &def->default_value;
+    switch (def->type) {
+        case ARG_TYPE_FLAG:
+            fprintf(out, "{.flag = %s}", v->flag ? "true" : "false");
+            break;
+        case ARG_TYPE_STRING:
+            fputs("{.string = (char *)", out);
+            emit_string(out, v->string);
+            fputc('}', out);
+            break;
+        case ARG_TYPE_INT:
+            fprintf(out, "{.integer = %d}", v->integer);
+            break;
+        case ARG_TYPE_FLOAT:
+            fputs("{.floating = ", out);
+            emit_real(out, v->floating, true);
+            fputc('}', out);
+            break;
+        case ARG_TYPE_INT64:
+        case ARG_TYPE_DURATION:
+            if (v->integer64 == INT64_MIN) {
+                fputs("{.integer64 = INT64_MIN}", out);
+            } else {
+                fprintf(out, "{.integer64 = INT64_C(%lld)}", (long long)v->integer64);
+            }
+            break;
+        case ARG_TYPE_UINT64:
+        case ARG_TYPE_SIZE:
+            fprintf(out, "{.uinteger64 = UINT64_C(%llu)}", (unsigned long long)v->uinteger64);
+            break;
+        case ARG_TYPE_DOUBLE:
+            fputs("{.floating64 = ", out);
+            emit_real(out, v->floating64, false);
+            fputc('}', out);
+            break;
+        default:
+            fputs("{0}", out);
+            break;
+    }
+}
+
+static const char *base_name(const char *path) {
+    const char *slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+static void indent(FILE *out, int depth) {
+    for (int i = 0; i < depth; i++) {
+        fputs("    ", out);
+    }
+}
+
+static int compare_names(const void *a, const void *b) {
+    const gen_name_t *x = a;
+    const gen_name_t *y = b;
+    if (x->length != y->length) {
+        return x->length < y->length ? -1 : 1;
+    }
+    return memcmp(x->name, y->name, x->length);
+}
+
+/**
+ * Emit a decision tree over names of one length
+ * Each level switches on the byte that splits the candidates into the
+ * most groups, so every leaf holds exactly one candidate.
+ */
+static void emit_tree(FILE *out, gen_name_t *names, size_t count, int depth) {
+    size_t length = names[0].length;
+    if (count == 1) {
+        indent(out, depth);
+        fputs("return memcmp(name, ", out);
+        emit_string(out, names[0].name);
+        fprintf(out, ", %zu) == 0 ? %zu : -1;\n", length, names[0].definition);
+        return;
+    }
+
+    size_t best = 0;
+    size_t best_groups = 0;
+    for (size_t p = 0; p < length; p++) {
+        bool seen[UCHAR_MAX + 1] = {false};
+        size_t groups = 0;
+        for (size_t i = 0; i < count; i++) {
+            unsigned char c = (unsigned char)names[i].name[p];
+            groups += !seen[c];
+            seen[c] = true;
+        }
+        if (groups > best_groups) {
+            best = p;
+            best_groups = groups;
+        }
+    }
+
+    // Names are sorted, but not by the chosen byte; gather each group in turn
+    indent(out, depth);
+    fprintf(out, "switch (name[%zu]) {\n", best);
+    bool done[UCHAR_MAX + 1] = {false};
+    gen_name_t *group = malloc(count * sizeof(gen_name_t));
+    if (!group) {
+        fprintf(stderr, "arg-gen: out of memory\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < count; i++) {
+        unsigned char c = (unsigned char)names[i].name[best];
+        if (done[c]) {
+            continue;
+        }
+        done[c] = true;
+        size_t n = 0;
+        for (size_t j = i; j < count; j++) {
+            if ((unsigned char)names[j].name[best] == c) {
+                group[n++] = names[j];
+            }
+        }
+        indent(out, depth + 1);
+        fputs("case ", out);
+        emit_char(out, (char)c);
+        fputs(":\n", out);
+        emit_tree(out, group, n, depth + 2);
+    }
+    free(group);
+    indent(out, depth + 1);
+    fputs("default:\n", out);
+    indent(out, depth + 2);
+    fputs("return -1;\n", out);
+    indent(out, depth);
+    fputs("}\n", out);
+}
+
+/**
+ * Emit the name matcher
+ */
+static int emit_matcher(FILE *out, const gen_spec_t *spec) {
+    size_t count = 0;
+    gen_name_t *names = malloc(spec->count * 2 * sizeof(gen_name_t) + 1);
+    if (!names) {
+        fprintf(stderr, "arg-gen: out of memory\n");
+        return -1;
+    }
+    for (size_t i = 0; i < spec->count; i++) {
+        const gen_def_t *def = &spec->defs[i];
+        names[count++] = (gen_name_t){def->long_name, strlen(def->long_name), i};
+        if (def->short_name) {
+            names[count++] = (gen_name_t){def->short_name, strlen(def->short_name), i};
+        }
+    }
+    qsort(names, count, sizeof(gen_name_t), compare_names);
+
+    fputs("/**\n"
+          " * Find the definition for an option name, comparing at most one candidate\n"
+          " */\n"
+          "static int match(const char *name) {\n", out);
+    if (count == 0) {
+        fputs("    (void)name;\n    return -1;\n}\n", out);
+        free(names);
+        return 0;
+    }
+    fputs("    switch (strlen(name)) {\n", out);
+    for (size_t i = 0; i < count;) {
+        size_t j = i;
+        while (j < count && names[j].length == names[i].length) {
+            j++;
+        }
+        fprintf(out, "        case %zu:\n", names[i].length);
+        emit_tree(out, names + i, j - i, 3);
+        i = j;
+    }
+    fputs("        default:\n"
+          "            return -1;\n"
+          "    }\n"
+          "}\n", out);
+    free(names);
+    return 0;
+}
+
+static int emit_header(FILE *out, const gen_spec_t *spec, const char *prefix) {
+    char guard[MAX_NAME_LENGTH];
+    constant_name(guard, sizeof(guard), prefix, "--H");
+    char constant[MAX_NAME_LENGTH * 2];
+
+    fprintf(out, "// Generated by arg-gen from %s, do not edit\n\n", base_name(spec->input));
+    fprintf(out, "#ifndef %s\n#define %s\n\n#include \"program_arguments.h\"\n\n", guard, guard);
+    fputs("/**\n"
+          " * Argument handles, for the arg_parser_get_*_h() getters\n"
+          " */\n"
+          "enum {\n", out);
+    for (size_t i = 0; i < spec->count; i++) {
+        constant_name(constant, sizeof(constant), prefix, spec->defs[i].long_name);
+        fprintf(out, "    %s = %zu,\n", constant, i);
+    }
+    fputs("};\n\n", out);
+
+    // Validators are declared here so their definitions are type-checked
+    for (size_t i = 0; i < spec->count; i++) {
+        const char *validator = spec->defs[i].validator;
+        bool first = validator != NULL;
+        for (size_t j = 0; first && j < i; j++) {
+            first = !spec->defs[j].validator || strcmp(spec->defs[j].validator, validator) != 0;
+        }
+        if (first) {
+            fprintf(out, "bool %s(arg_value_t value, arg_type_t type, "
+                         "char *error_msg, size_t error_msg_size);\n", validator);
+        }
+    }
+
+    fprintf(out, "\n/**\n"
+                 " * Static spec for arg_parser_create_for_spec(), never destroyed\n"
+                 " */\n"
+                 "extern const arg_spec_t %s_spec;\n\n#endif\n", prefix);
+    return 0;
+}
+
+static int emit_source(FILE *out, const gen_spec_t *spec, const char *prefix,
+                       const char *header) {
+    fprintf(out, "// Generated by arg-gen from %s, do not edit\n\n", base_name(spec->input));
+    fprintf(out, "#include \"%s\"\n#include <string.h>\n\n", header);
+
+    fprintf(out, "static const arg_def_t definitions[%zu] = {\n", spec->count ? spec->count : 1);
+    for (size_t i = 0; i < spec->count; i++) {
+        const gen_def_t *def = &spec->defs[i];
+        size_t t = 0;
+        while (types[t].type != def->type) {
+            t++;
+        }
+        fputs("    {", out);
+        if (def->short_name) {
+            emit_string(out, def->short_name);
+        } else {
+            fputs("NULL", out);
+        }
+        fputs(", ", out);
+        emit_string(out, def->long_name);
+        fputs(", ", out);
+        if (def->description) {
+            emit_string(out, def->description);
+        } else {
+            fputs("NULL", out);
+        }
+        fprintf(out, ", %s, %s, ", types[t].constant, def->required ? "true" : "false");
+        emit_default(out, def);
+        fprintf(out, ", %s, ", def->validator ? def->validator : "NULL");
+        emit_char(out, def->delimiter);
+        fputs("},\n", out);
+    }
+    fputs("};\n\n", out);
+
+    fprintf(out, "static const uint8_t traits[%zu] = {\n", spec->count ? spec->count : 1);
+    for (size_t i = 0; i < spec->count; i++) {
+        const gen_def_t *def = &spec->defs[i];
+        size_t t = 0;
+        while (types[t].type != def->type) {
+            t++;
+        }
+        fprintf(out, "    %s%s%s,\n", types[t].constant,
+                def->required ? " | ARG_TRAIT_REQUIRED" : "",
+                def->validator ? " | ARG_TRAIT_VALIDATOR" : "");
+    }
+    fputs("};\n\n", out);
+
+    if (emit_matcher(out, spec) != 0) {
+        return -1;
+    }
+
+    fprintf(out, "\nconst arg_spec_t %s_spec = {\n"
+                 "    .definitions = (arg_def_t *)definitions,\n"
+                 "    .definition_count = %zu,\n"
+                 "    .definition_capacity = %zu,\n"
+                 "    .traits = (uint8_t *)traits,\n"
+                 "    .match = match,\n"
+                 "};\n", prefix, spec->count, spec->count);
+    return 0;
+}
+
+/**
+ * Write one output file, removing it again if anything fails
+ */
+static int write_file(const char *path, const gen_spec_t *spec, const char *prefix,
+                      const char *header) {
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        perror(path);
+        return -1;
+    }
+    int rc = header ? emit_source(out, spec, prefix, header) : emit_header(out, spec, prefix);
+    if (fclose(out) != 0 || rc != 0) {
+        remove(path);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Read a whole file
+ * The buffer always has at least one spare byte past the end
+ */
+static char *read_file(const char *path, size_t *length) {
+    FILE *in = fopen(path, "rb");
+    if (!in) {
+        perror(path);
+        return NULL;
+    }
+    size_t capacity = 4096;
+    size_t size = 0;
+    char *text = malloc(capacity);
+    while (text) {
+        size += fread(text + size, 1, capacity - size, in);
+        if (size < capacity) {
+            break;
+        }
+        capacity *= 2;
+        char *grown = realloc(text, capacity);
+        if (!grown) {
+            free(text);
+        }
+        text = grown;
+    }
+    if (!text || ferror(in)) {
+        fprintf(stderr, "arg-gen: cannot read %s\n", path);
+        free(text);
+        text = NULL;
+    }
+    fclose(in);
+    *length = size;
+    return text;
+}
+
+/**
+ * Print the spec syntax after the option help
+ */
+static void print_spec_format(void) {
+    printf("\nSpec lines:\n"
+           "  <type> --long [-s] [required] [default=V] [delimiter=C] [validator=F] [\"description\"]\n"
+           "\nTypes:");
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        printf(" %s", types[t].name);
+    }
+    printf("\n\nNot supported: defaults for range-list and list types (\"type takes no\n"
+           "default\") and declarative constraints; check those with validator=F.\n");
+}
+
+int main(int argc, char *argv[]) {
+    arg_parser_t *parser = arg_parser_create();
+    if (!parser) {
+        fprintf(stderr, "arg-gen: out of memory\n");
+        return 1;
+    }
+    arg_parser_add_string(parser, "-i", "--input", "Argument spec to compile", true, NULL);
+    arg_parser_add_string(parser, "-n", "--name", "Symbol prefix, <name>_spec is exported", true, NULL);
+    arg_parser_add_string(parser, NULL, "--source", "Generated C source path", true, NULL);
+    arg_parser_add_string(parser, NULL, "--header", "Generated header path", true, NULL);
+
+    if (arg_parser_parse(parser, argc, argv) != 0) {
+        arg_parser_print_help(parser, argv[0]);
+        print_spec_format();
+        arg_parser_destroy(parser);
+        return 1;
+    }
+
+    gen_spec_t spec = {0};
+    spec.input = arg_parser_get_string(parser, "--input");
+    const char *prefix = arg_parser_get_string(parser, "--name");
+    const char *source = arg_parser_get_string(parser, "--source");
+    const char *header = arg_parser_get_string(parser, "--header");
+
+    int status = 1;
+    size_t length;
+    char *text = NULL;
+    if (!is_identifier(prefix)) {
+        fprintf(stderr, "arg-gen: --name must be a C identifier: %s\n", prefix);
+    } else if ((text = read_file(spec.input, &length)) != NULL &&
+               parse_spec(&spec, text, length) == 0 &&
+               check_unique(&spec, prefix) == 0 &&
+               write_file(header, &spec, prefix, NULL) == 0 &&
+               write_file(source, &spec, prefix, base_name(header)) == 0) {
+        status = 0;
+    }
+
+    free(spec.defs);
+    free(text);
+    arg_parser_destroy(parser);
+    return status;
+}